@@ -0,0 +1,116 @@
+#pragma once
+
+// stl
+#include <functional>
+#include <vector>
+
+// kengine
+#include "kengine.hpp"
+
+namespace koverlay {
+    template<typename Comp>
+    struct ComponentObserver {
+        using Callback = std::function<void(kengine::Entity &, Comp &)>;
+        Callback onAttach;
+        Callback onDetach; // called while the component is still attached
+        Callback onModified;
+    };
+
+    // Observers of `Comp`, attached to a single entity so the overlay and plugins share them through the kengine state
+    template<typename Comp>
+    struct ComponentEventsComponent {
+        struct Subscription {
+            size_t id;
+            ComponentObserver<Comp> observer;
+        };
+
+        std::vector<Subscription> subscriptions;
+        size_t nextID = 0;
+    };
+
+    namespace componentEvents {
+        // Returned by `subscribe`, whatever the component. Code that may be unloaded must release its subscriptions first,
+        // as their callbacks point into it (e.g. C++ plugins, from their `unloadPlugin` export)
+        struct Subscription {
+            void (*unsubscribe)(size_t id) = nullptr;
+            size_t id = 0;
+
+            void release() noexcept {
+                if (unsubscribe)
+                    unsubscribe(id);
+                unsubscribe = nullptr;
+            }
+        };
+
+        template<typename Comp>
+        ComponentEventsComponent<Comp> & getChannel() noexcept {
+            static kengine::EntityID id = kengine::INVALID_ID; // cached per module, entity IDs are shared
+            if (id == kengine::INVALID_ID) {
+                for (const auto & [e, channel] : kengine::entities.with<ComponentEventsComponent<Comp>>())
+                    id = e.id;
+                if (id == kengine::INVALID_ID)
+                    id = kengine::entities.create([](kengine::Entity & e) noexcept {
+                        e += ComponentEventsComponent<Comp>{};
+                    }).id;
+            }
+            return kengine::entities[id].get<ComponentEventsComponent<Comp>>();
+        }
+
+        template<typename Comp>
+        void unsubscribe(size_t id) noexcept {
+            auto & subscriptions = getChannel<Comp>().subscriptions;
+            std::erase_if(subscriptions, [&](const auto & subscription) noexcept { return subscription.id == id; });
+        }
+
+        template<typename Comp>
+        Subscription subscribe(ComponentObserver<Comp> observer) noexcept {
+            auto & channel = getChannel<Comp>();
+            const auto id = channel.nextID++;
+            channel.subscriptions.push_back({ id, std::move(observer) });
+            return { unsubscribe<Comp>, id };
+        }
+
+        namespace impl {
+            template<typename Comp, typename MemberPtr>
+            void notify(kengine::Entity & e, MemberPtr callback) noexcept {
+                auto & comp = e.get<Comp>();
+                // Observers may subscribe or unsubscribe while being notified, so copy each callback before calling it
+                for (size_t i = 0; i < getChannel<Comp>().subscriptions.size(); ++i) {
+                    const auto func = getChannel<Comp>().subscriptions[i].observer.*callback;
+                    if (func)
+                        func(e, comp);
+                }
+            }
+        }
+
+        template<typename Comp>
+        void notifyAttached(kengine::Entity & e) noexcept {
+            impl::notify<Comp>(e, &ComponentObserver<Comp>::onAttach);
+        }
+
+        template<typename Comp>
+        void notifyDetached(kengine::Entity & e) noexcept {
+            impl::notify<Comp>(e, &ComponentObserver<Comp>::onDetach);
+        }
+
+        template<typename Comp>
+        void notifyModified(kengine::Entity & e) noexcept {
+            impl::notify<Comp>(e, &ComponentObserver<Comp>::onModified);
+        }
+
+        // Components attached inside `entities.create` are announced by the overlay once the entity exists
+        // These are for components attached or detached afterwards
+        template<typename Comp>
+        Comp & attach(kengine::Entity & e, Comp comp) noexcept {
+            e += std::move(comp);
+            notifyAttached<Comp>(e);
+            return e.get<Comp>();
+        }
+
+        template<typename Comp>
+        void detach(kengine::Entity & e) noexcept {
+            notifyDetached<Comp>(e);
+            e.detach<Comp>();
+        }
+    }
+}
@@ -0,0 +1,51 @@
+#pragma once
+
+// stl
+#include <span>
+#include <vector>
+
+// kengine
+#include "kengine.hpp"
+
+namespace koverlay {
+    // Dense set of the tools whose ImGuiToolComponent is enabled, maintained by the overlay from ImGuiToolComponent events
+    // Lets tool runners iterate over enabled tools only, however many tools are installed
+    struct EnabledToolsComponent {
+        std::vector<bool> enabled; // indexed by entity ID
+        std::vector<kengine::EntityID> ids; // unordered
+        std::vector<size_t> positions; // indexed by entity ID, position in `ids`
+
+        bool contains(kengine::EntityID id) const noexcept {
+            return id < enabled.size() && enabled[id];
+        }
+
+        void insert(kengine::EntityID id) noexcept {
+            if (contains(id))
+                return;
+            if (id >= enabled.size()) {
+                enabled.resize(id + 1, false);
+                positions.resize(id + 1, 0);
+            }
+            enabled[id] = true;
+            positions[id] = ids.size();
+            ids.push_back(id);
+        }
+
+        void erase(kengine::EntityID id) noexcept {
+            if (!contains(id))
+                return;
+            enabled[id] = false;
+            const auto pos = positions[id];
+            ids[pos] = ids.back();
+            positions[ids[pos]] = pos;
+            ids.pop_back();
+        }
+    };
+
+    // Copy the span before enabling or disabling tools while iterating over it
+    inline std::span<const kengine::EntityID> getEnabledTools() noexcept {
+        for (const auto & [e, set] : kengine::entities.with<EnabledToolsComponent>())
+            return set.ids;
+        return {};
+    }
+}
@@ -0,0 +1,41 @@
+#pragma once
+
+// stl
+#include <cstdint>
+#include <utility>
+
+// feed
+#include "koverlay_feed.h"
+
+namespace koverlay {
+    // Read-only handle to a shared-memory data feed, see koverlay_feed.h
+    class Feed {
+    public:
+        Feed() noexcept = default;
+        explicit Feed(const char * name) noexcept : _feed(koverlay_feed_open(name)) {}
+        ~Feed() noexcept { koverlay_feed_close(_feed); }
+
+        Feed(Feed && other) noexcept : _feed(std::exchange(other._feed, nullptr)) {}
+        Feed & operator=(Feed && other) noexcept { std::swap(_feed, other._feed); return *this; }
+        Feed(const Feed &) = delete;
+        Feed & operator=(const Feed &) = delete;
+
+        // False if the feed doesn't exist, or its producer closed it
+        explicit operator bool() const noexcept { return _feed != nullptr && !koverlay_feed_closed(_feed); }
+        const koverlay_feed_header & getHeader() const noexcept { return *koverlay_feed_get_header(_feed); }
+
+        // Rings
+        uint64_t getHead() const noexcept { return koverlay_feed_head(_feed); }
+        template<typename T>
+        bool read(uint64_t index, T & out) const noexcept { return sizeof(T) == getHeader().element_size && koverlay_feed_read(_feed, index, &out); }
+
+        // Values
+        template<typename T>
+        bool get(T & out) const noexcept { return sizeof(T) == getHeader().element_size && koverlay_feed_get(_feed, &out); }
+
+        koverlay_feed * handle() const noexcept { return _feed; }
+
+    private:
+        koverlay_feed * _feed = nullptr;
+    };
+}
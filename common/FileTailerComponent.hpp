@@ -0,0 +1,57 @@
+#pragma once
+
+// stl
+#include <functional>
+#include <memory>
+#include <string>
+#include <string_view>
+#include <vector>
+
+// kengine
+#include "kengine.hpp"
+
+namespace koverlay {
+    // File followed by the overlay as it grows, read into memory and indexed by line
+    // Updated at the start of each frame: views into `contents` are only valid until the next frame
+    struct TailedFile {
+        std::string path;
+        std::string_view contents;
+        // Offset of the first character of each line, up to `indexedSize`
+        // Large files are indexed over several frames, so lines appear progressively
+        std::vector<size_t> lineStarts;
+        size_t indexedSize = 0;
+        // Incremented when the file is truncated or replaced, and indexed again from scratch
+        size_t generation = 0;
+
+        size_t getLineCount() const noexcept {
+            if (lineStarts.empty())
+                return 0;
+            // The last line isn't counted while it may continue past `indexedSize`, or if it's empty (i.e. the file ends with a newline)
+            if (indexedSize < contents.size() || lineStarts.back() == contents.size())
+                return lineStarts.size() - 1;
+            return lineStarts.size();
+        }
+
+        // Without its line ending
+        std::string_view getLine(size_t index) const noexcept {
+            const auto start = lineStarts[index];
+            auto end = index + 1 < lineStarts.size() ? lineStarts[index + 1] - 1 : contents.size();
+            if (end > start && contents[end - 1] == '\r')
+                --end;
+            return contents.substr(start, end - start);
+        }
+    };
+
+    // Attached by the overlay to a system entity
+    struct FileTailerComponent {
+        // Follows `path` for as long as the returned pointer is held. The file may not exist yet
+        // Systems calling it, or reading TailedFiles, should declare `resources::of<TailedFile>()` as a write in their SystemAccessComponent
+        std::function<std::shared_ptr<const TailedFile>(const std::string & path)> open;
+    };
+
+    inline std::shared_ptr<const TailedFile> tailFile(const std::string & path) noexcept {
+        for (const auto & [e, tailer] : kengine::entities.with<FileTailerComponent>())
+            return tailer.open(path);
+        return nullptr;
+    }
+}
@@ -0,0 +1,14 @@
+#pragma once
+
+// stl
+#include <functional>
+
+namespace koverlay {
+    // Called on the main thread once all systems have run and the frame has been submitted, before the next frame starts
+    // Meant for deferrable work (e.g. garbage collection) that would otherwise land in the middle of a frame
+    // Only called by the overlay's scheduler, i.e. not when the `parallelSystems` option is disabled
+    struct FrameEndComponent {
+        // `frameTime` is how long the frame's systems took to run, in seconds, including waiting for vsync
+        std::function<void(float frameTime)> onFrameEnd;
+    };
+}
@@ -0,0 +1,25 @@
+#pragma once
+
+// stl
+#include <cstddef>
+
+#include "imgui.h"
+
+namespace koverlay {
+    // Layout of the ImGui types shared by the overlay and a plugin, which the overlay checks before drawing the plugin
+    // Filled in with the ImGui headers of whoever constructs it
+    struct ImGuiABI {
+        int version = IMGUI_VERSION_NUM;
+        size_t ioSize = sizeof(ImGuiIO);
+        size_t styleSize = sizeof(ImGuiStyle);
+        size_t vertexSize = sizeof(ImDrawVert);
+        size_t indexSize = sizeof(ImDrawIdx);
+        // The plugin uses the ImGui exported by the overlay, rather than its own copy
+        bool shared = false;
+
+        bool isCompatibleWith(const ImGuiABI & other) const noexcept {
+            return version == other.version && ioSize == other.ioSize && styleSize == other.styleSize &&
+                vertexSize == other.vertexSize && indexSize == other.indexSize;
+        }
+    };
+}
@@ -0,0 +1,100 @@
+#pragma once
+
+// stl
+#include <algorithm>
+#include <cstddef>
+#include <memory>
+#include <utility>
+
+namespace koverlay {
+    struct Job;
+
+    // Work-stealing job system shared by the overlay and all plugins, so they don't each start their own threads
+    // Only made of function pointers, so plugins built with another compiler or standard library can use it
+    struct Jobs {
+        using Function = void (*)(void * data);
+
+        // The returned job holds a reference, which must be given back to `release`
+        Job * (*create)(Function function, void * data) = nullptr;
+        // `next` starts once `previous` has finished. Must be called before `next` is submitted
+        void (*then)(Job * previous, Job * next) = nullptr;
+        // Starts `job` as soon as all the jobs it comes after have finished
+        void (*submit)(Job * job) = nullptr;
+        // Returns once `job` has finished. Job threads run other jobs meanwhile. Other threads run `job` itself if it's ready and
+        // hasn't started yet, but never other jobs, which may take much longer than they're willing to wait
+        void (*wait)(Job * job) = nullptr;
+        bool (*finished)(const Job * job) = nullptr;
+        void (*release)(Job * job) = nullptr;
+
+        size_t workerCount = 0;
+    };
+
+    namespace jobs {
+        // Creates a job running `func`, which is copied
+        template<typename Func>
+        Job * create(const Jobs & jobs, Func && func) noexcept {
+            using Stored = std::decay_t<Func>;
+            const auto stored = new Stored(std::forward<Func>(func));
+            return jobs.create([](void * data) {
+                const std::unique_ptr<Stored> func((Stored *)data);
+                (*func)();
+            }, stored);
+        }
+
+        // Runs `func` as soon as possible
+        template<typename Func>
+        Job * run(const Jobs & jobs, Func && func) noexcept {
+            const auto job = create(jobs, std::forward<Func>(func));
+            jobs.submit(job);
+            return job;
+        }
+
+        // Runs `func` once `previous` has finished
+        template<typename Func>
+        Job * then(const Jobs & jobs, Job * previous, Func && func) noexcept {
+            const auto job = create(jobs, std::forward<Func>(func));
+            jobs.then(previous, job);
+            jobs.submit(job);
+            return job;
+        }
+
+        inline void waitAndRelease(const Jobs & jobs, Job * job) noexcept {
+            jobs.wait(job);
+            jobs.release(job);
+        }
+
+        // Calls `func(begin, end)` on ranges that cover [0, count), in parallel, and returns once all of them are done
+        // `jobs` may be null, in which case `func` is called once, on the calling thread
+        template<typename Func>
+        void parallelFor(const Jobs * jobs, size_t count, Func && func, size_t minRangeSize = 1) noexcept {
+            if (count == 0)
+                return;
+
+            // A few ranges per thread, so threads that finish early can take some from the others
+            constexpr size_t maxJobs = 256;
+            const size_t threads = jobs ? jobs->workerCount + 1 : 1;
+            const auto rangeCount = std::clamp<size_t>(count / std::max<size_t>(minRangeSize, 1), 1, std::min(threads * 4, maxJobs + 1));
+            if (rangeCount == 1) {
+                func(size_t(0), count);
+                return;
+            }
+
+            const auto rangeSize = (count + rangeCount - 1) / rangeCount;
+            const auto getRange = [&](size_t range) noexcept {
+                return std::make_pair(std::min(count, range * rangeSize), std::min(count, (range + 1) * rangeSize));
+            };
+
+            // The calling thread runs the first range itself
+            Job * rangeJobs[maxJobs];
+            const auto jobCount = rangeCount - 1;
+            for (size_t i = 0; i < jobCount; ++i) {
+                const auto [begin, end] = getRange(i + 1);
+                rangeJobs[i] = run(*jobs, [&func, begin = begin, end = end] { func(begin, end); });
+            }
+
+            func(size_t(0), getRange(0).second);
+            for (size_t i = 0; i < jobCount; ++i)
+                waitAndRelease(*jobs, rangeJobs[i]);
+        }
+    }
+}
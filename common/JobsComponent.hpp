@@ -0,0 +1,20 @@
+#pragma once
+
+// kengine
+#include "kengine.hpp"
+
+// api
+#include "Jobs.hpp"
+
+namespace koverlay {
+    // Attached by the overlay to a system entity
+    struct JobsComponent {
+        const Jobs * jobs = nullptr;
+    };
+
+    inline const Jobs * getJobs() noexcept {
+        for (const auto & [e, comp] : kengine::entities.with<JobsComponent>())
+            return comp.jobs;
+        return nullptr;
+    }
+}
@@ -0,0 +1,14 @@
+#pragma once
+
+// stl
+#include <functional>
+#include <string>
+
+namespace koverlay {
+    // Section of the Profiler tool, drawn with ImGui under a collapsing header
+    // Drawn from the Profiler's own system, so `draw` must not assume it runs alongside the system that attached it
+    struct ProfilerSectionComponent {
+        std::string name;
+        std::function<void()> draw;
+    };
+}
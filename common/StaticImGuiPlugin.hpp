@@ -0,0 +1,18 @@
+#pragma once
+
+// api
+#include "ImGuiABI.hpp"
+#include "Jobs.hpp"
+
+struct ImGuiContext;
+
+namespace koverlay {
+    // Entry points of a tool built with framework.hpp and linked into the overlay (see KOVERLAY_STATIC_PLUGINS),
+    // which would otherwise be exported from its library
+    struct StaticImGuiPlugin {
+        const char * (*getNameAndEnabled)(bool ** outEnabled);
+        void (*drawImGui)(ImGuiContext & context, float scale);
+        void (*setJobs)(const Jobs * jobs);
+        void (*getImGuiABI)(ImGuiABI * abi);
+    };
+}
@@ -0,0 +1,33 @@
+#pragma once
+
+// stl
+#include <string>
+#include <typeinfo>
+#include <vector>
+
+namespace koverlay {
+    // Declares what a system's functions::Execute reads and writes, so the overlay can run it alongside the systems it doesn't conflict with
+    // Systems without one may access anything: they run on the main thread, after all systems created before them and before all systems created after them
+    // Should be attached along with the Execute, when the system is created
+    struct SystemAccessComponent {
+        std::vector<std::string> reads;
+        std::vector<std::string> writes;
+        // Systems that access `resources::imgui` always run on the main thread
+        bool mainThread = false;
+    };
+
+    namespace resources {
+        // ImGui's global context: any call to ImGui
+        inline const std::string imgui = "ImGui";
+        // The Lua state
+        inline const std::string lua = "Lua";
+        // Creating or removing entities, and attaching or detaching components. Declared systems implicitly read it
+        inline const std::string entities = "Entities";
+
+        // A component's contents, or any other type's
+        template<typename T>
+        std::string of() noexcept {
+            return typeid(T).name();
+        }
+    }
+}
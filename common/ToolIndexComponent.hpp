@@ -0,0 +1,29 @@
+#pragma once
+
+// stl
+#include <span>
+#include <vector>
+
+// kengine
+#include "kengine.hpp"
+#include "data/NameComponent.hpp"
+
+namespace koverlay {
+    // Tool entities (with a NameComponent and an ImGuiToolComponent), sorted by name
+    // Maintained by the overlay as tools are created and removed, so readers never need to sort
+    struct ToolIndexComponent {
+        struct Entry {
+            kengine::EntityID id;
+            decltype(kengine::NameComponent::name) name;
+        };
+
+        std::vector<Entry> entries;
+    };
+
+    // Entries are only valid until the next tool is created or removed
+    inline std::span<const ToolIndexComponent::Entry> getSortedTools() noexcept {
+        for (const auto & [e, index] : kengine::entities.with<ToolIndexComponent>())
+            return index.entries;
+        return {};
+    }
+}
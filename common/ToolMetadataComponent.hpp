@@ -0,0 +1,12 @@
+#pragma once
+
+// stl
+#include <string>
+
+namespace koverlay {
+    // Optional information about a tool, read from its manifest
+    struct ToolMetadataComponent {
+        std::string category;
+        float cost = 0.f; // declared by the tool's author, in milliseconds per frame
+    };
+}
@@ -16,7 +16,9 @@ function copyTo() {
     fi
 
     rm -rf $DEST/$SOURCE && cp -r $SOURCE $DEST
-    ln adjust.cnf $DEST
+    # A symlink rather than a hard link, as the overlay replaces adjust.cnf by renaming a new file over it,
+    # which would give each directory its own copy
+    ln -sf "$PWD/adjust.cnf" $DEST/adjust.cnf
 }
 
 copyTo bin
@@ -0,0 +1,62 @@
+#ifndef _WIN32
+# define _POSIX_C_SOURCE 200809L /* nanosleep */
+#endif
+
+#include <math.h>
+#include <signal.h>
+#include <stdio.h>
+
+#ifdef _WIN32
+# include <windows.h>
+#else
+# include <time.h>
+#endif
+
+#include "koverlay_feed.h"
+
+static volatile sig_atomic_t g_running = 1;
+
+static void stop(int signal) {
+	(void)signal;
+	g_running = 0;
+}
+
+static void sleep_ms(int ms) {
+#ifdef _WIN32
+	Sleep(ms);
+#else
+	const struct timespec duration = { 0, ms * 1000000L };
+	nanosleep(&duration, NULL);
+#endif
+}
+
+typedef struct {
+	double count;
+	double last;
+} stats;
+
+int main(void) {
+	// A ring of samples, and a value summarizing them
+	koverlay_feed * samples = koverlay_feed_create_ring("example", KOVERLAY_FEED_DOUBLE, sizeof(double), 1024);
+	koverlay_feed * summary = koverlay_feed_create_value("example-stats", KOVERLAY_FEED_DOUBLE, sizeof(stats));
+	if (samples == NULL || summary == NULL) {
+		fprintf(stderr, "Failed to create feeds\n");
+		return 1;
+	}
+
+	signal(SIGINT, stop);
+	printf("Feeding 'example' and 'example-stats', press Ctrl+C to stop\n");
+
+	stats s = { 0, 0 };
+	while (g_running) {
+		s.last = sin(s.count / 20.0);
+		++s.count;
+		koverlay_feed_push(samples, &s.last);
+		koverlay_feed_set(summary, &s);
+		sleep_ms(10);
+	}
+
+	koverlay_feed_close(samples);
+	koverlay_feed_close(summary);
+	return 0;
+}
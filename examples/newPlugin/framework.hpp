@@ -1,15 +1,25 @@
 #pragma once
 
+// overlay api, from the `common` directory
+#include "ImGuiABI.hpp"
+#include "Jobs.hpp"
+
 static float g_scale;
+// The overlay's job system, to use instead of starting threads. May be null (e.g. when sandboxed), which koverlay::jobs::parallelFor handles
+// Jobs should be waited on before `imguiFunction` returns, as the plugin may be reloaded or unloaded between frames
+static const koverlay::Jobs * g_jobs = nullptr;
 
 static bool PLUGIN_ENABLED; // Used to know if window is open
 static const char * getName();
 static void imguiFunction();
 
-#if defined(__unix__) || defined(__APPLE__)
+#ifdef KOVERLAY_STATIC_PLUGIN
+// Linked into the overlay, which finds the entry points through the variable named by `KOVERLAY_STATIC_PLUGIN`, defined at the end of this file
+# include "StaticImGuiPlugin.hpp"
+# define EXPORT static
+#elif defined(__unix__) || defined(__APPLE__)
 # define EXPORT extern "C"
-#endif
-#ifdef _WIN32
+#elif defined(_WIN32)
 # define EXPORT extern "C" __declspec(dllexport)
 #endif
 
@@ -18,6 +28,19 @@ EXPORT const char * getNameAndEnabled(bool ** outEnabled) {
 	return getName();
 }
 
+// Checked by the overlay before the plugin is drawn
+// KOVERLAY_SHARED_IMGUI is defined when the plugin links against the overlay's ImGui instead of building its own copy
+EXPORT void getImGuiABI(koverlay::ImGuiABI * abi) {
+	*abi = {};
+#ifdef KOVERLAY_SHARED_IMGUI
+	abi->shared = true;
+#endif
+}
+
+EXPORT void setJobs(const koverlay::Jobs * jobs) {
+	g_jobs = jobs;
+}
+
 struct ImGuiContext;
 extern ImGuiContext * GImGui;
 
@@ -29,3 +52,12 @@ EXPORT void drawImGui(ImGuiContext & context, float scale) {
 
 	imguiFunction();
 }
+
+#ifdef KOVERLAY_STATIC_PLUGIN
+extern "C" const koverlay::StaticImGuiPlugin KOVERLAY_STATIC_PLUGIN = {
+	getNameAndEnabled,
+	drawImGui,
+	setJobs,
+	getImGuiABI
+};
+#endif
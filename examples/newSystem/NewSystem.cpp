@@ -11,6 +11,9 @@
 
 #include "imgui.h"
 
+// overlay api, from the `common` directory
+#include "SystemAccessComponent.hpp"
+
 // can use this function to properly scale child windows and other elements
 static float getScale() noexcept;
 
@@ -31,6 +34,11 @@ EXPORT void loadKenginePlugin(void * state) noexcept {
 			}
 			ImGui::End();
 		}};
+
+		// Lets systems that don't use ImGui run in parallel with this one
+		e += koverlay::SystemAccessComponent{
+			.writes = { koverlay::resources::imgui }
+		};
 	};
 }
 
@@ -0,0 +1,101 @@
+#ifndef KOVERLAY_FEED_H
+#define KOVERLAY_FEED_H
+
+/*
+ * Shared-memory data feeds, used to send data from other processes to koverlay tools
+ *
+ * A feed is either:
+ *  - a ring: a fixed number of elements, pushed by one or more threads and overwritten once full
+ *  - a value: a single element, replaced by one or more threads
+ * A feed has a single producing process. Any number of readers can map it. Reads never block producers, and never return
+ * torn elements
+ *
+ * Feeds are listed in a registry, so the overlay can show which ones exist
+ */
+
+#include <stddef.h>
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define KOVERLAY_FEED_MAGIC 0x4446564bu /* "KVFD" */
+#define KOVERLAY_FEED_VERSION 1u
+#define KOVERLAY_FEED_NAME_SIZE 64
+#define KOVERLAY_FEED_REGISTRY_SIZE 128
+
+typedef enum {
+    KOVERLAY_FEED_RING = 1,
+    KOVERLAY_FEED_VALUE = 2
+} koverlay_feed_kind;
+
+/* Type of the scalars an element is made of, so that readers such as Lua scripts can interpret it */
+typedef enum {
+    KOVERLAY_FEED_BYTES = 0,
+    KOVERLAY_FEED_FLOAT = 1,
+    KOVERLAY_FEED_DOUBLE = 2,
+    KOVERLAY_FEED_INT32 = 3,
+    KOVERLAY_FEED_INT64 = 4
+} koverlay_feed_type;
+
+/*
+ * Start of each feed's shared memory, followed by:
+ *  - rings: `capacity` slots, each a uint64_t sequence followed by the element, padded to 8 bytes
+ *  - values: the element
+ */
+typedef struct {
+    uint32_t magic;
+    uint32_t version;
+    uint32_t kind;
+    uint32_t type;
+    uint32_t element_size;
+    uint32_t capacity;
+    uint64_t head; /* rings: number of elements pushed so far */
+    uint64_t sequence; /* values: odd while being written */
+    uint64_t closed; /* set once the producer closes the feed, or a new producer replaces it */
+    uint64_t producer; /* process id of the producer, so that a feed left over by one that crashed can be replaced */
+    uint64_t reserved[1];
+} koverlay_feed_header;
+
+typedef struct koverlay_feed koverlay_feed;
+
+/*
+ * Producers. Feeds are removed when their producer closes them
+ * Return NULL if a running process, including this one, already produces a feed of that name
+ */
+koverlay_feed * koverlay_feed_create_ring(const char * name, koverlay_feed_type type, uint32_t element_size, uint32_t capacity);
+koverlay_feed * koverlay_feed_create_value(const char * name, koverlay_feed_type type, uint32_t element_size);
+/*
+ * Thread-safe. Return 0 if `feed` is of the wrong kind
+ * Pushing also returns 0, dropping the element, if its slot is still being written by a thread a whole lap behind
+ */
+int koverlay_feed_push(koverlay_feed * feed, const void * element);
+int koverlay_feed_set(koverlay_feed * feed, const void * value);
+
+/* Readers */
+koverlay_feed * koverlay_feed_open(const char * name);
+/* Copy of the header taken when the feed was opened. Its live fields are read with koverlay_feed_head and koverlay_feed_closed */
+const koverlay_feed_header * koverlay_feed_get_header(const koverlay_feed * feed);
+/* Rings: index of the next element to be pushed. Elements [head - capacity, head) may be read */
+uint64_t koverlay_feed_head(const koverlay_feed * feed);
+/* Rings: copies element `index` to `out`. Returns 0 if it hasn't been pushed yet, or has been overwritten */
+int koverlay_feed_read(const koverlay_feed * feed, uint64_t index, void * out);
+/* Values: copies the current value to `out`. Returns 0 if it's never been set, or is being written too often to be read */
+int koverlay_feed_get(const koverlay_feed * feed, void * out);
+/* Closed feeds won't be updated anymore, and should be reopened to find their new producer */
+int koverlay_feed_closed(const koverlay_feed * feed);
+
+void koverlay_feed_close(koverlay_feed * feed);
+
+/*
+ * Copies the names of up to `max` existing feeds to `names`, returns how many were copied
+ * Checks that each feed's producer is still running, which takes a system call per feed
+ */
+size_t koverlay_feed_list(char (*names)[KOVERLAY_FEED_NAME_SIZE], size_t max);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
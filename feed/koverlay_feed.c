@@ -0,0 +1,539 @@
+#ifndef _WIN32
+# define _POSIX_C_SOURCE 200809L /* ftruncate, kill, shm_open */
+#endif
+
+#include "koverlay_feed.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#ifdef _WIN32
+# include <windows.h>
+#else
+# include <errno.h>
+# include <fcntl.h>
+# include <signal.h>
+# include <sys/mman.h>
+# include <sys/stat.h>
+# include <unistd.h>
+#endif
+
+/*
+ * Atomics on plain integers, so that the header layout is the same for C and C++ users
+ */
+
+#ifdef _MSC_VER
+static uint64_t load_acquire(const uint64_t * p) { return (uint64_t)InterlockedCompareExchange64((volatile LONG64 *)p, 0, 0); }
+static uint64_t load_relaxed(const uint64_t * p) { return *(const volatile uint64_t *)p; }
+static void store_relaxed(uint64_t * p, uint64_t value) { *(volatile uint64_t *)p = value; }
+static void store_release(uint64_t * p, uint64_t value) { InterlockedExchange64((volatile LONG64 *)p, (LONG64)value); }
+static uint64_t fetch_add(uint64_t * p, uint64_t value) { return (uint64_t)InterlockedExchangeAdd64((volatile LONG64 *)p, (LONG64)value); }
+static int compare_exchange(uint64_t * p, uint64_t expected, uint64_t desired) {
+    return (uint64_t)InterlockedCompareExchange64((volatile LONG64 *)p, (LONG64)desired, (LONG64)expected) == expected;
+}
+static uint32_t load_acquire32(const uint32_t * p) { return (uint32_t)InterlockedCompareExchange((volatile LONG *)p, 0, 0); }
+static void store_release32(uint32_t * p, uint32_t value) { InterlockedExchange((volatile LONG *)p, (LONG)value); }
+static void fence_acquire(void) { MemoryBarrier(); }
+static void fence_release(void) { MemoryBarrier(); }
+#else
+static uint64_t load_acquire(const uint64_t * p) { return __atomic_load_n(p, __ATOMIC_ACQUIRE); }
+static uint64_t load_relaxed(const uint64_t * p) { return __atomic_load_n(p, __ATOMIC_RELAXED); }
+static void store_relaxed(uint64_t * p, uint64_t value) { __atomic_store_n(p, value, __ATOMIC_RELAXED); }
+static void store_release(uint64_t * p, uint64_t value) { __atomic_store_n(p, value, __ATOMIC_RELEASE); }
+static uint64_t fetch_add(uint64_t * p, uint64_t value) { return __atomic_fetch_add(p, value, __ATOMIC_ACQ_REL); }
+static int compare_exchange(uint64_t * p, uint64_t expected, uint64_t desired) {
+    return __atomic_compare_exchange_n(p, &expected, desired, 0, __ATOMIC_ACQ_REL, __ATOMIC_RELAXED);
+}
+static uint32_t load_acquire32(const uint32_t * p) { return __atomic_load_n(p, __ATOMIC_ACQUIRE); }
+static void store_release32(uint32_t * p, uint32_t value) { __atomic_store_n(p, value, __ATOMIC_RELEASE); }
+static void fence_acquire(void) { __atomic_thread_fence(__ATOMIC_ACQUIRE); }
+static void fence_release(void) { __atomic_thread_fence(__ATOMIC_RELEASE); }
+#endif
+
+/* A value that keeps changing while it's read is given up on after this many attempts */
+#define MAX_READ_ATTEMPTS 64
+/* Same for a ring slot still being written by a producer a whole lap behind, whose element is then dropped */
+#define MAX_WRITE_ATTEMPTS 1024
+
+/*
+ * Shared memory
+ */
+
+typedef struct {
+    void * data;
+    size_t size;
+    int created; /* zero-filled, rather than an existing segment */
+#ifdef _WIN32
+    HANDLE handle;
+#endif
+} mapping;
+
+static void get_system_name(char * out, size_t size, const char * name) {
+#ifdef _WIN32
+    snprintf(out, size, "Local\\koverlay-%s", name);
+#else
+    snprintf(out, size, "/koverlay-%s", name);
+#endif
+}
+
+/*
+ * Creates the segment if `size` isn't 0, opens an existing one otherwise
+ * An existing segment is opened instead of being created, unless `exclusive` is set, in which case this fails. Windows
+ * can't tell, as a segment removed by its creator lives on until its last reader closes it
+ */
+static int map_memory(mapping * out, const char * name, size_t size, int writable, int exclusive) {
+    char system_name[KOVERLAY_FEED_NAME_SIZE + 32];
+    get_system_name(system_name, sizeof(system_name), name);
+    memset(out, 0, sizeof(*out));
+
+#ifdef _WIN32
+    if (size != 0)
+        out->handle = CreateFileMappingA(INVALID_HANDLE_VALUE, NULL, PAGE_READWRITE, (DWORD)((unsigned long long)size >> 32), (DWORD)size, system_name);
+    else
+        out->handle = OpenFileMappingA(writable ? FILE_MAP_ALL_ACCESS : FILE_MAP_READ, FALSE, system_name);
+    if (out->handle == NULL)
+        return 0;
+    out->created = size != 0 && GetLastError() != ERROR_ALREADY_EXISTS;
+    (void)exclusive;
+
+    out->data = MapViewOfFile(out->handle, writable ? FILE_MAP_ALL_ACCESS : FILE_MAP_READ, 0, 0, size);
+    MEMORY_BASIC_INFORMATION info;
+    if (out->data == NULL || VirtualQuery(out->data, &info, sizeof(info)) == 0) {
+        if (out->data)
+            UnmapViewOfFile(out->data);
+        CloseHandle(out->handle);
+        return 0;
+    }
+    out->size = size != 0 ? size : info.RegionSize;
+#else
+    const int flags = size != 0 ? O_RDWR | O_CREAT | (exclusive ? O_EXCL : 0) : (writable ? O_RDWR : O_RDONLY);
+    const int fd = shm_open(system_name, flags, 0600);
+    if (fd < 0)
+        return 0;
+
+    struct stat st;
+    if (fstat(fd, &st) != 0 || (size == 0 && st.st_size == 0) || (size != 0 && (size_t)st.st_size < size && ftruncate(fd, (off_t)size) != 0)) {
+        close(fd);
+        return 0;
+    }
+    if (size == 0)
+        size = (size_t)st.st_size;
+
+    void * data = mmap(NULL, size, writable ? PROT_READ | PROT_WRITE : PROT_READ, MAP_SHARED, fd, 0);
+    close(fd);
+    if (data == MAP_FAILED)
+        return 0;
+    out->data = data;
+    out->size = size;
+    out->created = (flags & O_EXCL) != 0; /* otherwise unknown, as shm_open doesn't tell */
+#endif
+    return 1;
+}
+
+static void unmap_memory(mapping * m) {
+#ifdef _WIN32
+    UnmapViewOfFile(m->data);
+    CloseHandle(m->handle);
+#else
+    munmap(m->data, m->size);
+#endif
+    memset(m, 0, sizeof(*m));
+}
+
+static void remove_memory(const char * name) {
+#ifndef _WIN32 /* Windows removes mappings once their last handle is closed */
+    char system_name[KOVERLAY_FEED_NAME_SIZE + 32];
+    get_system_name(system_name, sizeof(system_name), name);
+    shm_unlink(system_name);
+#else
+    (void)name;
+#endif
+}
+
+/*
+ * Producers
+ */
+
+static uint64_t get_process_id(void) {
+#ifdef _WIN32
+    return GetCurrentProcessId();
+#else
+    return (uint64_t)getpid();
+#endif
+}
+
+/* A process id may have been reused since its producer crashed, in which case its feed is wrongly kept */
+static int is_process_running(uint64_t id) {
+    if (id == 0)
+        return 0;
+#ifdef _WIN32
+    HANDLE process = OpenProcess(SYNCHRONIZE, FALSE, (DWORD)id);
+    if (process == NULL)
+        return GetLastError() == ERROR_ACCESS_DENIED;
+    const int running = WaitForSingleObject(process, 0) == WAIT_TIMEOUT;
+    CloseHandle(process);
+    return running;
+#else
+    return kill((pid_t)id, 0) == 0 || errno == EPERM;
+#endif
+}
+
+/*
+ * Registry
+ */
+
+#define REGISTRY_NAME "feeds"
+
+enum { ENTRY_FREE = 0, ENTRY_CLAIMED = 1, ENTRY_USED = 2 };
+
+typedef struct {
+    uint64_t state;
+    uint64_t producer; /* process id */
+    char name[KOVERLAY_FEED_NAME_SIZE];
+} registry_entry;
+
+typedef struct {
+    registry_entry entries[KOVERLAY_FEED_REGISTRY_SIZE];
+} registry;
+
+/* Created by whichever process needs it first, and kept mapped until exit */
+static registry * get_registry(void) {
+    static registry * instance = NULL;
+    if (instance != NULL)
+        return instance;
+
+    mapping m;
+    if (!map_memory(&m, REGISTRY_NAME, sizeof(registry), 1, 0))
+        return NULL;
+    instance = (registry *)m.data;
+    return instance;
+}
+
+static void register_feed(const char * name) {
+    registry * r = get_registry();
+    if (r == NULL)
+        return;
+
+    /* Left over by a producer that crashed */
+    for (size_t i = 0; i < KOVERLAY_FEED_REGISTRY_SIZE; ++i)
+        if (load_acquire(&r->entries[i].state) == ENTRY_USED && strcmp(r->entries[i].name, name) == 0) {
+            store_release(&r->entries[i].producer, get_process_id());
+            return;
+        }
+
+    for (size_t i = 0; i < KOVERLAY_FEED_REGISTRY_SIZE; ++i) {
+        registry_entry * entry = &r->entries[i];
+        if (!compare_exchange(&entry->state, ENTRY_FREE, ENTRY_CLAIMED))
+            continue;
+        strncpy(entry->name, name, KOVERLAY_FEED_NAME_SIZE - 1);
+        entry->name[KOVERLAY_FEED_NAME_SIZE - 1] = '\0';
+        store_relaxed(&entry->producer, get_process_id());
+        store_release(&entry->state, ENTRY_USED);
+        return;
+    }
+}
+
+static void unregister_feed(const char * name) {
+    registry * r = get_registry();
+    if (r == NULL)
+        return;
+
+    for (size_t i = 0; i < KOVERLAY_FEED_REGISTRY_SIZE; ++i) {
+        registry_entry * entry = &r->entries[i];
+        if (load_acquire(&entry->state) == ENTRY_USED && strcmp(entry->name, name) == 0 &&
+            load_acquire(&entry->producer) == get_process_id())
+            compare_exchange(&entry->state, ENTRY_USED, ENTRY_FREE);
+    }
+}
+
+size_t koverlay_feed_list(char (*names)[KOVERLAY_FEED_NAME_SIZE], size_t max) {
+    registry * r = get_registry();
+    if (r == NULL)
+        return 0;
+
+    size_t count = 0;
+    for (size_t i = 0; i < KOVERLAY_FEED_REGISTRY_SIZE && count < max; ++i) {
+        registry_entry * entry = &r->entries[i];
+        if (load_acquire(&entry->state) != ENTRY_USED)
+            continue;
+
+        char name[KOVERLAY_FEED_NAME_SIZE];
+        memcpy(name, entry->name, sizeof(name));
+        name[KOVERLAY_FEED_NAME_SIZE - 1] = '\0';
+
+        /* Producers that crashed never unregistered their feed */
+        if (!is_process_running(load_acquire(&entry->producer))) {
+            compare_exchange(&entry->state, ENTRY_USED, ENTRY_FREE);
+            continue;
+        }
+
+        memcpy(names[count++], name, KOVERLAY_FEED_NAME_SIZE);
+    }
+    return count;
+}
+
+/*
+ * Feeds
+ */
+
+struct koverlay_feed {
+    koverlay_feed_header * header;
+    /* The producer can rewrite the shared header at any time, so only this copy, validated when opening, is trusted */
+    koverlay_feed_header info;
+    mapping memory;
+    int owner;
+    char name[KOVERLAY_FEED_NAME_SIZE];
+};
+
+static size_t align8(size_t size) {
+    return (size + 7) & ~(size_t)7;
+}
+
+static size_t get_slot_size(const koverlay_feed_header * header) {
+    return sizeof(uint64_t) + align8(header->element_size);
+}
+
+/* Returns 0 if it doesn't fit in a size_t */
+static size_t get_feed_size(const koverlay_feed_header * header) {
+    if (header->kind != KOVERLAY_FEED_RING)
+        return sizeof(koverlay_feed_header) + header->element_size;
+    if (header->capacity > (SIZE_MAX - sizeof(koverlay_feed_header)) / get_slot_size(header))
+        return 0;
+    return sizeof(koverlay_feed_header) + (size_t)header->capacity * get_slot_size(header);
+}
+
+static char * get_slot(const koverlay_feed * feed, uint64_t index) {
+    return (char *)(feed->header + 1) + (size_t)(index % feed->info.capacity) * get_slot_size(&feed->info);
+}
+
+static koverlay_feed * create(const char * name, koverlay_feed_kind kind, koverlay_feed_type type, uint32_t element_size, uint32_t capacity) {
+    if (name == NULL || name[0] == '\0' || strlen(name) >= KOVERLAY_FEED_NAME_SIZE || element_size == 0 || capacity == 0)
+        return NULL;
+
+    koverlay_feed_header header;
+    memset(&header, 0, sizeof(header));
+    header.magic = KOVERLAY_FEED_MAGIC;
+    header.version = KOVERLAY_FEED_VERSION;
+    header.kind = kind;
+    header.type = type;
+    header.element_size = element_size;
+    header.capacity = capacity;
+    header.producer = get_process_id();
+    if (get_feed_size(&header) == 0)
+        return NULL;
+
+    koverlay_feed * feed = (koverlay_feed *)calloc(1, sizeof(koverlay_feed));
+    if (feed == NULL)
+        return NULL;
+    snprintf(feed->name, sizeof(feed->name), "%s", name);
+
+    char feed_name[KOVERLAY_FEED_NAME_SIZE + 8];
+    snprintf(feed_name, sizeof(feed_name), "feed-%s", name);
+
+    /* Only replaced if left over by a producer that crashed, whose readers are then told to reopen the feed */
+    uint64_t previous_producer = 0;
+    mapping previous;
+    if (map_memory(&previous, feed_name, 0, 1, 0)) {
+        koverlay_feed_header * previous_header = (koverlay_feed_header *)previous.data;
+        if (previous.size >= sizeof(koverlay_feed_header)) {
+            previous_producer = load_acquire(&previous_header->producer);
+            if (is_process_running(previous_producer)) {
+                unmap_memory(&previous);
+                free(feed);
+                return NULL;
+            }
+            store_release(&previous_header->closed, 1);
+        }
+        unmap_memory(&previous);
+        remove_memory(feed_name);
+    }
+    if (!map_memory(&feed->memory, feed_name, get_feed_size(&header), 1, 1)) {
+        free(feed);
+        return NULL;
+    }
+
+    /*
+     * Another producer of the same name may have been created since the check above
+     * A new segment has no producer yet. Only Windows may instead reuse the one left over by the crashed producer
+     */
+    feed->header = (koverlay_feed_header *)feed->memory.data;
+    const uint64_t expected_producer = feed->memory.created ? 0 : previous_producer;
+    if (!compare_exchange(&feed->header->producer, expected_producer, header.producer)) {
+        const int created = feed->memory.created;
+        unmap_memory(&feed->memory);
+        if (created)
+            remove_memory(feed_name);
+        free(feed);
+        return NULL;
+    }
+
+    /* Windows reuses the segment left over by a crashed producer, whose slots' sequences are ahead of the new head */
+    memset(feed->header + 1, 0, feed->memory.size - sizeof(koverlay_feed_header));
+
+    /* Readers ignore the feed until its magic is set */
+    const uint32_t magic = header.magic;
+    header.magic = 0;
+    memcpy(feed->header, &header, sizeof(header));
+    store_release32(&feed->header->magic, magic);
+    header.magic = magic;
+    feed->info = header;
+
+    feed->owner = 1;
+    register_feed(name);
+    return feed;
+}
+
+koverlay_feed * koverlay_feed_create_ring(const char * name, koverlay_feed_type type, uint32_t element_size, uint32_t capacity) {
+    return create(name, KOVERLAY_FEED_RING, type, element_size, capacity);
+}
+
+koverlay_feed * koverlay_feed_create_value(const char * name, koverlay_feed_type type, uint32_t element_size) {
+    return create(name, KOVERLAY_FEED_VALUE, type, element_size, 1);
+}
+
+koverlay_feed * koverlay_feed_open(const char * name) {
+    if (name == NULL || strlen(name) >= KOVERLAY_FEED_NAME_SIZE)
+        return NULL;
+
+    koverlay_feed * feed = (koverlay_feed *)calloc(1, sizeof(koverlay_feed));
+    if (feed == NULL)
+        return NULL;
+    snprintf(feed->name, sizeof(feed->name), "%s", name);
+
+    char feed_name[KOVERLAY_FEED_NAME_SIZE + 8];
+    snprintf(feed_name, sizeof(feed_name), "feed-%s", name);
+    if (!map_memory(&feed->memory, feed_name, 0, 0, 0)) {
+        free(feed);
+        return NULL;
+    }
+
+    feed->header = (koverlay_feed_header *)feed->memory.data;
+    if (feed->memory.size < sizeof(koverlay_feed_header) || load_acquire32(&feed->header->magic) != KOVERLAY_FEED_MAGIC) {
+        koverlay_feed_close(feed);
+        return NULL;
+    }
+
+    const koverlay_feed_header * info = &feed->info;
+    memcpy(&feed->info, feed->header, sizeof(feed->info));
+    const size_t size = get_feed_size(info);
+    if (info->version != KOVERLAY_FEED_VERSION || (info->kind != KOVERLAY_FEED_RING && info->kind != KOVERLAY_FEED_VALUE) ||
+        info->element_size == 0 || info->capacity == 0 || size == 0 || size > feed->memory.size) {
+        koverlay_feed_close(feed);
+        return NULL;
+    }
+    return feed;
+}
+
+void koverlay_feed_close(koverlay_feed * feed) {
+    if (feed == NULL)
+        return;
+
+    if (feed->owner)
+        store_release(&feed->header->closed, 1);
+    unmap_memory(&feed->memory);
+    if (feed->owner) {
+        char feed_name[KOVERLAY_FEED_NAME_SIZE + 8];
+        snprintf(feed_name, sizeof(feed_name), "feed-%s", feed->name);
+        remove_memory(feed_name);
+        unregister_feed(feed->name);
+    }
+    free(feed);
+}
+
+const koverlay_feed_header * koverlay_feed_get_header(const koverlay_feed * feed) {
+    return &feed->info;
+}
+
+int koverlay_feed_closed(const koverlay_feed * feed) {
+    return load_acquire(&feed->header->closed) != 0;
+}
+
+int koverlay_feed_push(koverlay_feed * feed, const void * element) {
+    if (feed->info.kind != KOVERLAY_FEED_RING)
+        return 0;
+
+    const uint64_t index = fetch_add(&feed->header->head, 1);
+    char * slot = get_slot(feed, index);
+    uint64_t * sequence = (uint64_t *)slot;
+
+    /*
+     * The slot may still be written by a producer a lap behind (odd sequence), or already by one a lap ahead. Only one
+     * producer may write it at a time, so that a completed sequence always matches the element
+     */
+    for (int attempt = 0;; ++attempt) {
+        const uint64_t current = load_acquire(sequence);
+        if (current >= 2 * index + 2)
+            return 1; /* already overwritten */
+        if (current & 1) {
+            if (attempt >= MAX_WRITE_ATTEMPTS)
+                return 0;
+            continue;
+        }
+        if (compare_exchange(sequence, current, 2 * index + 1))
+            break;
+    }
+
+    fence_release();
+    memcpy(slot + sizeof(uint64_t), element, feed->info.element_size);
+    store_release(sequence, 2 * index + 2);
+    return 1;
+}
+
+uint64_t koverlay_feed_head(const koverlay_feed * feed) {
+    return load_acquire(&feed->header->head);
+}
+
+int koverlay_feed_read(const koverlay_feed * feed, uint64_t index, void * out) {
+    if (feed->info.kind != KOVERLAY_FEED_RING)
+        return 0;
+
+    const uint64_t head = load_acquire(&feed->header->head);
+    if (index >= head || head - index > feed->info.capacity)
+        return 0;
+
+    const char * slot = get_slot(feed, index);
+    const uint64_t * sequence = (const uint64_t *)slot;
+    const uint64_t before = load_acquire(sequence);
+    if (before != 2 * index + 2) /* still being written, or already overwritten */
+        return 0;
+    memcpy(out, slot + sizeof(uint64_t), feed->info.element_size);
+    fence_acquire();
+    return load_relaxed(sequence) == before;
+}
+
+int koverlay_feed_set(koverlay_feed * feed, const void * value) {
+    koverlay_feed_header * header = feed->header;
+    if (feed->info.kind != KOVERLAY_FEED_VALUE)
+        return 0;
+
+    /* Producers take turns by making the sequence odd */
+    uint64_t sequence;
+    do
+        sequence = load_relaxed(&header->sequence);
+    while ((sequence & 1) || !compare_exchange(&header->sequence, sequence, sequence + 1));
+
+    fence_release();
+    memcpy(header + 1, value, feed->info.element_size);
+    store_release(&header->sequence, sequence + 2);
+    return 1;
+}
+
+int koverlay_feed_get(const koverlay_feed * feed, void * out) {
+    const koverlay_feed_header * header = feed->header;
+    if (feed->info.kind != KOVERLAY_FEED_VALUE)
+        return 0;
+
+    for (int attempt = 0; attempt < MAX_READ_ATTEMPTS; ++attempt) {
+        const uint64_t before = load_acquire(&header->sequence);
+        if (before == 0)
+            return 0;
+        if (before & 1)
+            continue;
+        memcpy(out, header + 1, feed->info.element_size);
+        fence_acquire();
+        if (load_relaxed(&header->sequence) == before)
+            return 1;
+    }
+    return 0;
+}
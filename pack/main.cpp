@@ -0,0 +1,135 @@
+// koverlay-pack <scripts directory> <archive>
+// Precompiles the tools in a scripts directory, and the modules in its `lib` subdirectory, into an archive that the overlay maps at startup
+// See src/helpers/ScriptArchive.hpp for the format
+
+// stl
+#include <algorithm>
+#include <cstdio>
+#include <filesystem>
+#include <fstream>
+#include <iterator>
+#include <optional>
+#include <string>
+#include <vector>
+
+#include "lua.hpp"
+
+// project
+#include "helpers/ScriptArchive.hpp"
+#include "helpers/toolManifestHelper.hpp"
+
+namespace {
+    struct Packed {
+        ScriptArchive::Script script;
+        std::string bytecode;
+    };
+
+    // Debug information is kept, so errors still point at the original lines
+    bool compile(lua_State * L, const std::filesystem::path & path, const std::string & chunkName, std::string & bytecode) noexcept {
+        std::ifstream f(path, std::ios::binary);
+        if (!f) {
+            fprintf(stderr, "Failed to read %s\n", path.string().c_str());
+            return false;
+        }
+        const std::string source{ std::istreambuf_iterator<char>(f), std::istreambuf_iterator<char>() };
+
+        if (luaL_loadbufferx(L, source.data(), source.size(), ('@' + chunkName).c_str(), "t") != LUA_OK) {
+            fprintf(stderr, "%s\n", lua_tostring(L, -1));
+            lua_pop(L, 1);
+            return false;
+        }
+
+        bytecode.clear();
+        lua_dump(L, [](lua_State *, const void * data, size_t size, void * bytecode) {
+            static_cast<std::string *>(bytecode)->append(static_cast<const char *>(data), size);
+            return 0;
+        }, &bytecode, 0);
+        lua_pop(L, 1);
+        return true;
+    }
+
+    std::optional<ToolManifest> readManifest(const std::string & path) noexcept {
+        if (auto manifest = toolManifestHelper::readSidecar(path))
+            return manifest;
+        if (auto manifest = toolManifestHelper::readLuaHeader(path))
+            return manifest;
+        return toolManifestHelper::readLuaAssignments(path);
+    }
+}
+
+int main(int ac, const char ** av) {
+    if (ac != 3) {
+        fprintf(stderr, "usage: %s <scripts directory> <archive>\n", av[0]);
+        return 1;
+    }
+
+    const std::filesystem::path directory = av[1];
+    const auto L = luaL_newstate();
+    std::vector<Packed> packed;
+    bool ok = true;
+
+    std::error_code ec;
+    for (const auto & entry : std::filesystem::directory_iterator(directory, ec)) {
+        if (!entry.is_regular_file() || entry.path().extension() != ".lua")
+            continue;
+
+        const auto path = entry.path().string();
+        const auto manifest = readManifest(path);
+        if (!manifest) {
+            // The overlay would have to run it to find its name
+            fprintf(stderr, "%s has no manifest and doesn't assign TOOL_NAME a string literal\n", path.c_str());
+            ok = false;
+            continue;
+        }
+
+        Packed tool;
+        tool.script.kind = ScriptArchive::Kind::Tool;
+        tool.script.name = entry.path().filename().string();
+        tool.script.manifest = *manifest;
+        if (!compile(L, entry.path(), tool.script.name, tool.bytecode)) {
+            ok = false;
+            continue;
+        }
+        packed.push_back(std::move(tool));
+    }
+    if (ec) {
+        fprintf(stderr, "Failed to list %s: %s\n", av[1], ec.message().c_str());
+        return 1;
+    }
+
+    const auto lib = directory / "lib";
+    for (const auto & entry : std::filesystem::recursive_directory_iterator(lib, ec)) {
+        if (!entry.is_regular_file() || entry.path().extension() != ".lua")
+            continue;
+
+        // lib/format/numbers.lua is required as "format.numbers"
+        auto name = std::filesystem::relative(entry.path(), lib).replace_extension().generic_string();
+        std::ranges::replace(name, '/', '.');
+
+        Packed module;
+        module.script.kind = ScriptArchive::Kind::Module;
+        module.script.name = name;
+        if (!compile(L, entry.path(), name, module.bytecode)) {
+            ok = false;
+            continue;
+        }
+        packed.push_back(std::move(module));
+    }
+    lua_close(L);
+
+    if (!ok)
+        return 1;
+
+    std::vector<ScriptArchive::Script> scripts;
+    for (auto & p : packed) {
+        p.script.chunk = p.bytecode;
+        scripts.push_back(p.script);
+    }
+
+    if (!ScriptArchive::write(av[2], LUA_VERSION_NUM, scripts)) {
+        fprintf(stderr, "Failed to write %s\n", av[2]);
+        return 1;
+    }
+    printf("Packed %zu scripts into %s\n", scripts.size(), av[2]);
+    return 0;
+}
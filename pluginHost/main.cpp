@@ -0,0 +1,146 @@
+// koverlay-plugin-host <plugin> <shared memory name>
+// Runs an ImGui plugin in its own process on behalf of the overlay, which composites its draw lists
+// See src/helpers/drawDataTransport.hpp for the protocol
+
+// stl
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <thread>
+
+#ifdef _WIN32
+# include <windows.h>
+#else
+# include <cerrno>
+# include <dlfcn.h>
+# include <signal.h>
+#endif
+
+#include "imgui.h"
+
+// project
+#include "helpers/SharedMemory.hpp"
+#include "helpers/drawDataTransport.hpp"
+
+namespace {
+    using GetNameAndEnabledFunc = const char * (bool **);
+    using DrawImGuiFunc = void (ImGuiContext &, float);
+
+    // How long to sleep when the overlay hasn't sent new input
+    constexpr std::chrono::milliseconds idleSleep{ 1 };
+    constexpr std::chrono::milliseconds overlayCheckInterval{ 500 };
+
+    struct Plugin {
+        GetNameAndEnabledFunc * getNameAndEnabled = nullptr;
+        DrawImGuiFunc * drawImGui = nullptr;
+    };
+
+    // Never unloaded: the process exits with the plugin
+    Plugin loadPlugin(const char * path) noexcept {
+#ifdef _WIN32
+        const auto handle = LoadLibraryA(path);
+        if (handle == nullptr)
+            return {};
+        return {
+            (GetNameAndEnabledFunc *)GetProcAddress(handle, "getNameAndEnabled"),
+            (DrawImGuiFunc *)GetProcAddress(handle, "drawImGui")
+        };
+#else
+        const auto handle = dlopen(path, RTLD_NOW | RTLD_LOCAL);
+        if (handle == nullptr) {
+            fprintf(stderr, "%s\n", dlerror());
+            return {};
+        }
+        return {
+            (GetNameAndEnabledFunc *)dlsym(handle, "getNameAndEnabled"),
+            (DrawImGuiFunc *)dlsym(handle, "drawImGui")
+        };
+#endif
+    }
+
+    bool isRunning(uint64_t process) noexcept {
+#ifdef _WIN32
+        static const auto handle = OpenProcess(SYNCHRONIZE, FALSE, (DWORD)process);
+        return handle != nullptr && WaitForSingleObject(handle, 0) == WAIT_TIMEOUT;
+#else
+        return kill((pid_t)process, 0) == 0 || errno == EPERM;
+#endif
+    }
+}
+
+int main(int ac, const char ** av) {
+    if (ac != 3) {
+        fprintf(stderr, "usage: %s <plugin> <shared memory name>\n", av[0]);
+        return 1;
+    }
+
+    auto memory = SharedMemory::open(av[2]);
+    if (!memory || memory.size() < drawDataTransport::Channel::getSize()) {
+        fprintf(stderr, "Failed to open shared memory %s\n", av[2]);
+        return 1;
+    }
+
+    auto & channel = *static_cast<drawDataTransport::Channel *>(memory.data());
+    if (channel.magic != drawDataTransport::magic || channel.version != drawDataTransport::version ||
+        channel.vertexSize != sizeof(ImDrawVert) || channel.indexSize != sizeof(ImDrawIdx)) {
+        fprintf(stderr, "Incompatible overlay version\n");
+        return 1;
+    }
+
+    const auto plugin = loadPlugin(av[1]);
+    if (!plugin.getNameAndEnabled || !plugin.drawImGui) {
+        fprintf(stderr, "%s isn't an ImGui plugin\n", av[1]);
+        return 1;
+    }
+
+    ImGui::CreateContext();
+    auto & io = ImGui::GetIO();
+    io.IniFilename = nullptr;
+    io.BackendFlags |= ImGuiBackendFlags_RendererHasVtxOffset; // the overlay handles VtxOffset when compositing
+
+    unsigned char * pixels;
+    int width, height;
+    io.Fonts->GetTexDataAsAlpha8(&pixels, &width, &height);
+    io.Fonts->SetTexID(drawDataTransport::fontTexture);
+    channel.fontWidth = width;
+    channel.fontHeight = height;
+    channel.fontChecksum = drawDataTransport::getFontChecksum(pixels, width, height);
+
+    bool * enabled;
+    plugin.getNameAndEnabled(&enabled);
+    channel.ready.store(1, std::memory_order_release);
+
+    drawDataTransport::Input input;
+    drawDataTransport::Input previous;
+    uint32_t inputSequence = 0;
+    uint32_t back = drawDataTransport::initialBack;
+    auto lastOverlayCheck = std::chrono::steady_clock::now();
+
+    while (!channel.stop.load(std::memory_order_acquire)) {
+        const auto now = std::chrono::steady_clock::now();
+        if (now - lastOverlayCheck > overlayCheckInterval) {
+            if (!isRunning(channel.overlayProcess))
+                break;
+            lastOverlayCheck = now;
+        }
+
+        if (!drawDataTransport::readInput(channel, input, inputSequence)) {
+            std::this_thread::sleep_for(idleSleep);
+            continue;
+        }
+
+        drawDataTransport::applyInput(input, previous);
+        previous = input;
+
+        ImGui::NewFrame();
+        *enabled = input.enabled;
+        plugin.drawImGui(*ImGui::GetCurrentContext(), input.scale);
+        ImGui::Render();
+
+        if (!drawDataTransport::publishFrame(channel, back, *ImGui::GetDrawData(), *enabled))
+            fprintf(stderr, "Frame too large for the shared memory channel\n");
+    }
+
+    ImGui::DestroyContext();
+    return 0;
+}
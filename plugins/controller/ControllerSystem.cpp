@@ -1,14 +1,19 @@
+#include <vector>
+
 #include "kengine.hpp"
 #include "Export.hpp"
 
 #include "helpers/pluginHelper.hpp"
-#include "helpers/sortHelper.hpp"
 
 #include "data/NameComponent.hpp"
 #include "data/ImGuiToolComponent.hpp"
 #include "functions/Execute.hpp"
 #include "imgui.h"
 
+#include "ComponentEventsComponent.hpp"
+#include "ToolIndexComponent.hpp"
+#include "ToolMetadataComponent.hpp"
+
 EXPORT void loadKenginePlugin(void * state) noexcept {
 	kengine::pluginHelper::initPlugin(state);
 
@@ -22,12 +27,36 @@ EXPORT void loadKenginePlugin(void * state) noexcept {
 			if (!tool.enabled)
 				return;
 
+			// Notified once the window is done, as observers may create or remove tools, which invalidates the index
+			static std::vector<kengine::EntityID> toggled;
+			toggled.clear();
+
 			if (ImGui::Begin("Koverlay", &tool.enabled)) {
-				const auto sorted = kengine::sortHelper::getNameSortedEntities<0, kengine::ImGuiToolComponent>();
-				for (const auto & [e, name, tool] : sorted)
-					ImGui::Checkbox(name->name, &tool->enabled);
+				for (const auto & entry : koverlay::getSortedTools()) {
+					auto entity = kengine::entities[entry.id];
+					auto & entryTool = entity.get<kengine::ImGuiToolComponent>();
+					if (ImGui::Checkbox(entry.name.c_str(), &entryTool.enabled))
+						toggled.push_back(entry.id);
+					if (const auto metadata = entity.tryGet<koverlay::ToolMetadataComponent>(); metadata && ImGui::IsItemHovered()) {
+						const bool hasCategory = !metadata->category.empty();
+						const bool hasCost = metadata->cost > 0.f;
+						if (hasCategory && hasCost)
+							ImGui::SetTooltip("%s (%.2f ms)", metadata->category.c_str(), metadata->cost);
+						else if (hasCategory)
+							ImGui::SetTooltip("%s", metadata->category.c_str());
+						else if (hasCost)
+							ImGui::SetTooltip("%.2f ms", metadata->cost);
+					}
+				}
 			}
 			ImGui::End();
+
+			for (const auto id : toggled) {
+				auto entity = kengine::entities[id];
+				// An earlier observer may have removed it
+				if (entity.has<kengine::ImGuiToolComponent>())
+					koverlay::componentEvents::notifyModified<kengine::ImGuiToolComponent>(entity);
+			}
 		} };
 	};
 }
@@ -0,0 +1,43 @@
+#include "kengine.hpp"
+#include "Export.hpp"
+
+#include "helpers/pluginHelper.hpp"
+
+#include "data/NameComponent.hpp"
+#include "data/ImGuiToolComponent.hpp"
+#include "functions/Execute.hpp"
+#include "imgui.h"
+
+#include "ProfilerSectionComponent.hpp"
+#include "SystemAccessComponent.hpp"
+
+EXPORT void loadKenginePlugin(void * state) noexcept {
+	kengine::pluginHelper::initPlugin(state);
+
+	kengine::entities += [&](kengine::Entity & e) noexcept {
+		e += kengine::NameComponent{ "Profiler" };
+
+		auto & tool = e.attach<kengine::ImGuiToolComponent>();
+		tool.enabled = false;
+
+		e += kengine::functions::Execute{ [&](float deltaTime) noexcept {
+			if (!tool.enabled)
+				return;
+
+			if (ImGui::Begin("Profiler", &tool.enabled)) {
+				const auto & io = ImGui::GetIO();
+				ImGui::Text("Frame: %.2f ms (%.0f FPS)", 1000.f / io.Framerate, io.Framerate);
+
+				for (const auto & [sectionEntity, section] : kengine::entities.with<koverlay::ProfilerSectionComponent>())
+					if (ImGui::CollapsingHeader(section.name.c_str(), ImGuiTreeNodeFlags_DefaultOpen))
+						section.draw();
+			}
+			ImGui::End();
+		} };
+
+		e += koverlay::SystemAccessComponent{
+			.reads = { koverlay::resources::of<koverlay::ProfilerSectionComponent>() },
+			.writes = { koverlay::resources::imgui }
+		};
+	};
+}
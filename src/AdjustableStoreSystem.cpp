@@ -0,0 +1,328 @@
+#include "AdjustableStoreSystem.hpp"
+#include "kengine.hpp"
+
+// stl
+#include <algorithm>
+#include <charconv>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <iterator>
+#include <map>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+// kengine data
+#include "data/AdjustableComponent.hpp"
+
+// kengine functions
+#include "functions/Execute.hpp"
+
+// kengine helpers
+#include "helpers/logHelper.hpp"
+
+// project
+#include "helpers/BackgroundFileWriter.hpp"
+
+namespace {
+    struct impl {
+        // kengine's ImGuiAdjustableSystem is built with its own save file disabled (see CMakeLists.txt), so this is the only writer
+        static constexpr auto file = "adjust.cnf";
+
+        // Values are compared against the last saved state this often, rather than every frame
+        static constexpr float pollInterval = .1f;
+        // A write is only issued once values have stopped changing for this long
+        static constexpr float debounce = 1.f;
+
+        using Value = kengine::AdjustableComponent::Value;
+        using Type = Value::Type;
+
+        struct CachedValue {
+            kengine::EntityID entity;
+            Type type;
+            float data[4];
+        };
+
+        static inline float timeSincePoll = 0.f;
+        static inline float timeSinceChange = 0.f;
+        static inline bool dirty = false;
+        static inline std::vector<CachedValue> cache;
+        static inline std::vector<CachedValue> current;
+        static inline std::string buffer; // last written contents
+
+        // Parsed file, only re-parsed when its modification time changes, and updated with the values saved since
+        // Ordered, so that saving the same values always writes the same file
+        static inline struct {
+            std::filesystem::file_time_type mtime;
+            std::map<std::string, std::map<std::string, std::string>> sections;
+        } parsed;
+        static inline std::vector<kengine::EntityID> applied;
+        // Values set on the command line, which stored ones mustn't replace
+        static inline std::vector<std::pair<std::string, std::string>> ignored;
+
+        static void init(kengine::Entity & system) noexcept {
+            system += kengine::functions::Execute{ execute };
+        }
+
+        static void execute(float deltaTime) noexcept {
+            backgroundFileWriter().logErrors();
+
+            timeSincePoll += deltaTime;
+            timeSinceChange += deltaTime;
+            if (timeSincePoll < pollInterval)
+                return;
+            timeSincePoll = 0.f;
+
+            if (!dirty && backgroundFileWriter().idle())
+                refresh();
+            if (applyToNewEntities() && !dirty)
+                snapshotValues(cache); // values loaded from the file don't need saving
+
+            snapshotValues(current);
+            if (current.size() != cache.size() || std::memcmp(current.data(), cache.data(), current.size() * sizeof(CachedValue)) != 0) {
+                std::swap(current, cache);
+                dirty = true;
+                timeSinceChange = 0.f;
+                return;
+            }
+
+            if (dirty && timeSinceChange >= debounce)
+                save();
+        }
+
+        //
+        // Saving
+        //
+
+        static void snapshotValues(std::vector<CachedValue> & out) noexcept {
+            out.clear();
+            for (const auto & [e, adjustable] : kengine::entities.with<kengine::AdjustableComponent>())
+                for (const auto & value : adjustable.values) {
+                    auto & cached = out.emplace_back();
+                    std::memset(&cached, 0, sizeof(cached)); // compared with memcmp
+                    cached.entity = e.id;
+                    cached.type = value.type;
+                    switch (value.type) {
+                        case Type::Bool:
+                            cached.data[0] = read(value.boolStorage) ? 1.f : 0.f;
+                            break;
+                        case Type::Int:
+                        case Type::Enum:
+                            cached.data[0] = (float)read(value.intStorage);
+                            break;
+                        case Type::Float:
+                            cached.data[0] = read(value.floatStorage);
+                            break;
+                        case Type::Color: {
+                            const auto color = read(value.colorStorage);
+                            cached.data[0] = color.r;
+                            cached.data[1] = color.g;
+                            cached.data[2] = color.b;
+                            cached.data[3] = color.a;
+                            break;
+                        }
+                        default:
+                            break;
+                    }
+                }
+        }
+
+        template<typename Storage>
+        static auto read(const Storage & storage) noexcept {
+            return storage.ptr ? *storage.ptr : storage.value;
+        }
+
+        // Values are merged into `parsed`, so that entities created later (e.g. plugins loaded lazily or reloaded) get them,
+        // and sections of entities that don't exist anymore (e.g. unloaded plugins) are kept
+        static void save() noexcept {
+            dirty = false;
+
+            for (const auto & [e, adjustable] : kengine::entities.with<kengine::AdjustableComponent>()) {
+                auto & section = parsed.sections[adjustable.section];
+                for (const auto & value : adjustable.values) {
+                    buffer.clear();
+                    switch (value.type) {
+                        case Type::Bool:
+                            buffer += read(value.boolStorage) ? "true" : "false";
+                            break;
+                        case Type::Int:
+                        case Type::Enum:
+                            append(read(value.intStorage));
+                            break;
+                        case Type::Float:
+                            append(read(value.floatStorage));
+                            break;
+                        case Type::Color: {
+                            const auto color = read(value.colorStorage);
+                            append(color.r);
+                            buffer += ',';
+                            append(color.g);
+                            buffer += ',';
+                            append(color.b);
+                            buffer += ',';
+                            append(color.a);
+                            break;
+                        }
+                        default:
+                            break;
+                    }
+                    section[value.name.c_str()] = buffer;
+                }
+            }
+
+            buffer.clear();
+            for (const auto & [name, values] : parsed.sections) {
+                buffer += '[';
+                buffer += name;
+                buffer += "]\n";
+                for (const auto & [key, value] : values) {
+                    buffer += key;
+                    buffer += '=';
+                    buffer += value;
+                    buffer += '\n';
+                }
+            }
+
+            backgroundFileWriter().write(file, buffer);
+        }
+
+        template<typename T>
+        static void append(T value) noexcept {
+            char tmp[32];
+            const auto result = std::to_chars(tmp, tmp + sizeof(tmp), value);
+            buffer.append(tmp, result.ptr);
+        }
+
+        //
+        // Loading
+        //
+
+        static void refresh() noexcept {
+            std::error_code ec;
+            const auto mtime = std::filesystem::last_write_time(file, ec);
+            if (ec || mtime == parsed.mtime)
+                return;
+            parsed.mtime = mtime;
+
+            std::ifstream f(file, std::ios::binary);
+            const std::string content{ std::istreambuf_iterator<char>(f), std::istreambuf_iterator<char>() };
+            if (content == buffer) // our own last write
+                return;
+
+            // First load, or the file was edited by hand: (re-)apply it everywhere
+            parse(content);
+            applied.clear();
+        }
+
+        static bool applyToNewEntities() noexcept {
+            bool ret = false;
+            for (const auto & [e, adjustable] : kengine::entities.with<kengine::AdjustableComponent>()) {
+                if (std::find(applied.begin(), applied.end(), e.id) != applied.end())
+                    continue;
+                applied.push_back(e.id);
+                ret = true;
+
+                const auto section = parsed.sections.find(adjustable.section);
+                if (section == parsed.sections.end())
+                    continue;
+                for (auto & value : adjustable.values) {
+                    if (isIgnored(adjustable.section, value.name.c_str()))
+                        continue;
+                    const auto it = section->second.find(value.name.c_str());
+                    if (it != section->second.end())
+                        apply(value, it->second);
+                }
+            }
+            return ret;
+        }
+
+        static bool isIgnored(std::string_view section, std::string_view name) noexcept {
+            return std::ranges::any_of(ignored, [&](const auto & value) noexcept {
+                return value.first == section && value.second == name;
+            });
+        }
+
+        static void parse(std::string_view content) noexcept {
+            parsed.sections.clear();
+
+            std::map<std::string, std::string> * section = nullptr;
+            while (!content.empty()) {
+                const auto end = std::min(content.find('\n'), content.size());
+                auto line = content.substr(0, end);
+                content.remove_prefix(std::min(end + 1, content.size()));
+
+                if (!line.empty() && line.back() == '\r')
+                    line.remove_suffix(1);
+                if (line.empty())
+                    continue;
+
+                if (line.front() == '[' && line.back() == ']') {
+                    section = &parsed.sections[std::string(line.substr(1, line.size() - 2))];
+                    continue;
+                }
+
+                const auto equal = line.find('=');
+                if (section == nullptr || equal == std::string_view::npos)
+                    continue;
+                (*section)[std::string(line.substr(0, equal))] = line.substr(equal + 1);
+            }
+        }
+
+        static void apply(Value & value, std::string_view str) noexcept {
+            const auto set = [](auto & storage, const auto & newValue) noexcept {
+                storage.value = newValue;
+                if (storage.ptr)
+                    *storage.ptr = newValue;
+            };
+
+            const auto next = [&](auto & out) noexcept {
+                const auto result = std::from_chars(str.data(), str.data() + str.size(), out);
+                str.remove_prefix(std::min(str.size(), size_t(result.ptr - str.data() + 1))); // skip the ',' separating color components
+                return result.ec == std::errc();
+            };
+
+            switch (value.type) {
+                case Type::Bool:
+                    set(value.boolStorage, str == "true");
+                    break;
+                case Type::Int:
+                case Type::Enum: {
+                    int i;
+                    if (next(i))
+                        set(value.intStorage, i);
+                    break;
+                }
+                case Type::Float: {
+                    float f;
+                    if (next(f))
+                        set(value.floatStorage, f);
+                    break;
+                }
+                case Type::Color: {
+                    auto color = value.colorStorage.value;
+                    if (next(color.r) && next(color.g) && next(color.b) && next(color.a))
+                        set(value.colorStorage, color);
+                    break;
+                }
+                default:
+                    break;
+            }
+        }
+    };
+}
+
+kengine::EntityCreator * AdjustableStoreSystem() noexcept {
+    return impl::init;
+}
+
+void ignoreStoredAdjustable(std::string_view section, std::string_view name) noexcept {
+    impl::ignored.emplace_back(section, name);
+}
+
+void saveAdjustables() noexcept {
+    if (impl::dirty)
+        impl::save();
+    backgroundFileWriter().flush();
+    backgroundFileWriter().logErrors();
+}
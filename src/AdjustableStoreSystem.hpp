@@ -0,0 +1,14 @@
+#pragma once
+
+// stl
+#include <string_view>
+
+#include "EntityCreator.hpp"
+
+kengine::EntityCreator * AdjustableStoreSystem() noexcept;
+
+// Keeps the value stored in adjust.cnf from replacing the current one, e.g. because it was set on the command line
+void ignoreStoredAdjustable(std::string_view section, std::string_view name) noexcept;
+
+// Writes pending adjustable changes immediately, waiting for the background writer
+void saveAdjustables() noexcept;
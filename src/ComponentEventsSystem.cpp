@@ -0,0 +1,85 @@
+#include "ComponentEventsSystem.hpp"
+#include "kengine.hpp"
+
+// stl
+#include <vector>
+
+// kengine data
+#include "data/ImGuiToolComponent.hpp"
+#include "data/NameComponent.hpp"
+
+// kengine functions
+#include "functions/Execute.hpp"
+#include "functions/OnEntityCreated.hpp"
+#include "functions/OnEntityRemoved.hpp"
+
+// api
+#include "ComponentEventsComponent.hpp"
+#include "EnabledToolsComponent.hpp"
+#include "ToolIndexComponent.hpp"
+
+namespace {
+    struct impl {
+        static inline std::vector<kengine::EntityID> changed;
+
+        // Tools checked each frame for being enabled without a notification, so the fallback's cost doesn't grow with the catalog
+        static constexpr size_t sweptPerFrame = 32;
+        static inline size_t sweepPosition = 0;
+
+        static void init(kengine::Entity & system) noexcept {
+            system += kengine::functions::OnEntityCreated{ onEntityCreated };
+            system += kengine::functions::OnEntityRemoved{ onEntityRemoved };
+            system += kengine::functions::Execute{ execute };
+        }
+
+        static void onEntityCreated(kengine::Entity & e) noexcept {
+            if (e.has<kengine::NameComponent>())
+                koverlay::componentEvents::notifyAttached<kengine::NameComponent>(e);
+            if (e.has<kengine::ImGuiToolComponent>())
+                koverlay::componentEvents::notifyAttached<kengine::ImGuiToolComponent>(e);
+        }
+
+        static void onEntityRemoved(kengine::Entity & e) noexcept {
+            if (e.has<kengine::ImGuiToolComponent>())
+                koverlay::componentEvents::notifyDetached<kengine::ImGuiToolComponent>(e);
+            if (e.has<kengine::NameComponent>())
+                koverlay::componentEvents::notifyDetached<kengine::NameComponent>(e);
+        }
+
+        // Tools should be enabled and disabled through notifyModified, but windows passed `&tool.enabled` by kengine systems and
+        // plugins disable their tool directly when closed, and older plugins also enable tools directly
+        // Enabled tools are all checked every frame, as a closed window must stop being drawn at once. Others are checked a few at a
+        // time, so a tool enabled without a notification starts running within a few frames
+        static void execute(float deltaTime) noexcept {
+            changed.clear();
+            for (const auto id : koverlay::getEnabledTools()) {
+                const auto tool = kengine::entities[id].tryGet<kengine::ImGuiToolComponent>();
+                if (tool && !tool->enabled)
+                    changed.push_back(id);
+            }
+
+            const koverlay::EnabledToolsComponent * enabledTools = nullptr;
+            for (const auto & [e, set] : kengine::entities.with<koverlay::EnabledToolsComponent>())
+                enabledTools = &set;
+
+            const auto tools = koverlay::getSortedTools();
+            for (size_t i = 0; enabledTools && i < sweptPerFrame && i < tools.size(); ++i) {
+                sweepPosition = (sweepPosition + 1) % tools.size();
+                const auto id = tools[sweepPosition].id;
+                const auto tool = kengine::entities[id].tryGet<kengine::ImGuiToolComponent>();
+                if (tool && tool->enabled && !enabledTools->contains(id))
+                    changed.push_back(id);
+            }
+
+            // Notified once done iterating, as observers may create or remove tools
+            for (const auto id : changed) {
+                auto e = kengine::entities[id];
+                koverlay::componentEvents::notifyModified<kengine::ImGuiToolComponent>(e);
+            }
+        }
+    };
+}
+
+kengine::EntityCreator * ComponentEventsSystem() noexcept {
+    return impl::init;
+}
@@ -0,0 +1,5 @@
+#pragma once
+
+#include "EntityCreator.hpp"
+
+kengine::EntityCreator * ComponentEventsSystem() noexcept;
@@ -0,0 +1,163 @@
+#include "FeedSystem.hpp"
+#include "kengine.hpp"
+
+// stl
+#include <chrono>
+#include <cstring>
+#include <memory>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+// kengine data
+#include "data/LuaStateComponent.hpp"
+
+// api
+#include "Feed.hpp"
+
+namespace {
+    struct impl {
+        // Read-only view of a feed, whose elements are read straight from shared memory
+        struct FeedView {
+            std::shared_ptr<koverlay::Feed> feed;
+        };
+
+        // Scripts typically open their feeds every frame, so feeds stay open once opened
+        static inline std::unordered_map<std::string, std::shared_ptr<koverlay::Feed>> feeds;
+
+        // Listing feeds takes a system call per feed, so the list is only refreshed this often
+        static constexpr auto listInterval = std::chrono::seconds(1);
+        static inline std::vector<std::string> names;
+        static inline std::optional<std::chrono::steady_clock::time_point> lastListed;
+
+        static void init(kengine::Entity &) noexcept {
+            for (const auto &[e, state]: kengine::entities.with<kengine::LuaStateComponent>())
+                registerBindings(*state.state);
+        }
+
+        static void registerBindings(sol::state &state) noexcept {
+            state.new_usertype<FeedView>("KoverlayFeed", sol::no_constructor,
+                "kind", sol::property([](const FeedView &view) {
+                    return view.feed->getHeader().kind == KOVERLAY_FEED_RING ? "ring" : "value";
+                }),
+                "head", sol::property([](const FeedView &view) { return view.feed->getHead(); }),
+                "capacity", sol::property([](const FeedView &view) { return view.feed->getHeader().capacity; }),
+                "fields", sol::property([](const FeedView &view) { return getFieldCount(view.feed->getHeader()); }),
+                "get", [](const FeedView &view, uint64_t index, sol::optional<int> field) {
+                    return toLua(readFeedField(*view.feed, index, field.value_or(1)));
+                },
+                "latest", [](const FeedView &view, sol::optional<int> field) {
+                    const auto head = view.feed->getHead();
+                    return toLua(head == 0 ? std::nullopt : readFeedField(*view.feed, head - 1, field.value_or(1)));
+                },
+                "value", [](const FeedView &view, sol::optional<int> field) {
+                    return toLua(readFeedField(*view.feed, 0, field.value_or(1)));
+                }
+            );
+
+            auto table = state.create_named_table("feeds");
+            table["open"] = [](const std::string &name) -> sol::optional<FeedView> {
+                const auto feed = openFeed(name);
+                if (!feed)
+                    return sol::nullopt;
+                return FeedView{ feed };
+            };
+            table["list"] = [] {
+                return listFeeds();
+            };
+        }
+
+        static const std::vector<std::string> &listFeeds() noexcept {
+            const auto now = std::chrono::steady_clock::now();
+            if (lastListed && now - *lastListed < listInterval)
+                return names;
+            lastListed = now;
+
+            static char buffer[KOVERLAY_FEED_REGISTRY_SIZE][KOVERLAY_FEED_NAME_SIZE];
+            const auto count = koverlay_feed_list(buffer, KOVERLAY_FEED_REGISTRY_SIZE);
+            names.assign(buffer, buffer + count);
+            return names;
+        }
+
+        static size_t getScalarSize(uint32_t type) noexcept {
+            switch (type) {
+                case KOVERLAY_FEED_FLOAT:
+                case KOVERLAY_FEED_INT32:
+                    return 4;
+                case KOVERLAY_FEED_DOUBLE:
+                case KOVERLAY_FEED_INT64:
+                    return 8;
+                default:
+                    return 1;
+            }
+        }
+
+        static size_t getFieldCount(const koverlay_feed_header &header) noexcept {
+            return header.element_size / getScalarSize(header.type);
+        }
+
+        static std::vector<char> &getElementBuffer(const koverlay_feed_header &header) noexcept {
+            static std::vector<char> buffer;
+            buffer.resize(header.element_size);
+            return buffer;
+        }
+
+        static sol::optional<double> toLua(std::optional<double> value) noexcept {
+            if (!value)
+                return sol::nullopt;
+            return *value;
+        }
+
+        // `field` is 1-based, as is usual in Lua
+        static std::optional<double> readField(const koverlay_feed_header &header, const char *element, int field) noexcept {
+            if (field < 1 || size_t(field) > getFieldCount(header))
+                return std::nullopt;
+
+            const auto data = element + (field - 1) * getScalarSize(header.type);
+            const auto read = [&]<typename T>(T value) noexcept {
+                std::memcpy(&value, data, sizeof(value));
+                return double(value);
+            };
+            switch (header.type) {
+                case KOVERLAY_FEED_FLOAT:
+                    return read(0.f);
+                case KOVERLAY_FEED_DOUBLE:
+                    return read(0.0);
+                case KOVERLAY_FEED_INT32:
+                    return read(int32_t(0));
+                case KOVERLAY_FEED_INT64:
+                    return read(int64_t(0));
+                default:
+                    return read(uint8_t(0));
+            }
+        }
+    };
+}
+
+kengine::EntityCreator * FeedSystem() noexcept {
+	return impl::init;
+}
+
+std::shared_ptr<koverlay::Feed> openFeed(const std::string & name) noexcept {
+    auto & feed = impl::feeds[name];
+    if (feed && *feed)
+        return feed;
+
+    // Not opened yet, or its producer was replaced
+    auto opened = std::make_shared<koverlay::Feed>(name.c_str());
+    if (!*opened)
+        return nullptr;
+    feed = std::move(opened);
+    return feed;
+}
+
+std::optional<double> readFeedField(const koverlay::Feed & feed, uint64_t index, int field) noexcept {
+    const auto & header = feed.getHeader();
+    auto & buffer = impl::getElementBuffer(header);
+    const bool read = header.kind == KOVERLAY_FEED_RING ?
+        koverlay_feed_read(feed.handle(), index, buffer.data()) :
+        koverlay_feed_get(feed.handle(), buffer.data());
+    if (!read)
+        return std::nullopt;
+    return impl::readField(header, buffer.data(), field);
+}
@@ -0,0 +1,19 @@
+#pragma once
+
+// stl
+#include <memory>
+#include <optional>
+#include <string>
+
+#include "EntityCreator.hpp"
+
+// api
+#include "Feed.hpp"
+
+// Exposes shared-memory data feeds (see koverlay_feed.h) to Lua scripts, through the `feeds` table
+kengine::EntityCreator * FeedSystem() noexcept;
+
+// Feeds stay open once opened, and are reopened if their producer was replaced. Returns nullptr if the feed doesn't exist
+std::shared_ptr<koverlay::Feed> openFeed(const std::string & name) noexcept;
+// Reads scalar `field` (1-based) of element `index` (or of the value, for value feeds), converted to a double
+std::optional<double> readFeedField(const koverlay::Feed & feed, uint64_t index, int field) noexcept;
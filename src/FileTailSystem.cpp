@@ -0,0 +1,213 @@
+#include "FileTailSystem.hpp"
+#include "kengine.hpp"
+
+// stl
+#include <algorithm>
+#include <cstring>
+#include <fstream>
+#include <memory>
+#include <string>
+#include <unordered_map>
+
+// kengine data
+#include "data/LuaStateComponent.hpp"
+
+// kengine functions
+#include "functions/Execute.hpp"
+
+// imgui
+#include "imgui.h"
+
+// api
+#include "FileTailerComponent.hpp"
+#include "SystemAccessComponent.hpp"
+
+// project
+#include "helpers/FileWatcher.hpp"
+
+namespace {
+    struct impl {
+        struct Tail {
+            std::shared_ptr<koverlay::TailedFile> file;
+            // Copy of the file, read as it grows. A mapping would fault (SIGBUS) when reading past the end of a file truncated
+            // in place, e.g. by logrotate's copytruncate
+            std::string buffer;
+            FileWatcher::ID watch = 0;
+            bool changed = true;
+            float unusedTime = 0.f;
+        };
+
+        // Files are followed for this long once nobody holds them anymore, as scripts may reopen them every frame
+        static constexpr float unusedDelay = 5.f;
+        // Bytes read and indexed per frame, across all files, so opening a large file doesn't stall the overlay
+        static constexpr size_t budgetPerFrame = 16 * 1024 * 1024;
+
+        static inline std::unique_ptr<FileWatcher> watcher;
+        static inline std::unordered_map<std::string, Tail> tails;
+
+        // Read-only view of a tailed file, whose lines are drawn straight from its buffer
+        struct TailView {
+            std::shared_ptr<const koverlay::TailedFile> file;
+        };
+
+        static void init(kengine::Entity &system) noexcept {
+            watcher = std::make_unique<FileWatcher>();
+
+            system += koverlay::FileTailerComponent{ open };
+            system += kengine::functions::Execute{ update };
+            system += koverlay::SystemAccessComponent{
+                .writes = { koverlay::resources::of<koverlay::TailedFile>() }
+            };
+
+            for (const auto &[e, state]: kengine::entities.with<kengine::LuaStateComponent>())
+                registerBindings(*state.state);
+        }
+
+        static std::shared_ptr<const koverlay::TailedFile> open(const std::string &path) noexcept {
+            auto &tail = tails[path];
+            if (!tail.file) {
+                tail.file = std::make_shared<koverlay::TailedFile>();
+                tail.file->path = path;
+                tail.watch = watcher->add(path);
+            }
+            tail.unusedTime = 0.f;
+            return tail.file;
+        }
+
+        static void update(float deltaTime) noexcept {
+            watcher->poll([](FileWatcher::ID id) {
+                for (auto &[path, tail]: tails)
+                    if (tail.watch == id)
+                        tail.changed = true;
+            });
+
+            size_t budget = budgetPerFrame;
+            for (auto it = tails.begin(); it != tails.end();) {
+                auto &tail = it->second;
+                if (tail.file.use_count() == 1) {
+                    tail.unusedTime += deltaTime;
+                    if (tail.unusedTime >= unusedDelay) {
+                        watcher->remove(tail.watch);
+                        it = tails.erase(it);
+                        continue;
+                    }
+                }
+
+                if (tail.changed)
+                    budget -= refresh(tail, budget);
+                budget -= index(*tail.file, budget);
+                ++it;
+            }
+        }
+
+        // Reads what was appended since the last call, up to `budget` bytes. Returns the number of bytes read
+        // The file is reopened each time, so that a file replaced by log rotation is followed
+        static size_t refresh(Tail &tail, size_t budget) noexcept {
+            auto &file = *tail.file;
+            auto &buffer = tail.buffer;
+
+            std::ifstream stream(file.path, std::ios::binary | std::ios::ate);
+            const auto end = stream ? std::streamoff(stream.tellg()) : 0;
+            const auto size = end > 0 ? size_t(end) : 0;
+
+            // A file that shrank, or whose start changed, was truncated or replaced
+            bool replaced = size < buffer.size();
+            const auto checkedSize = std::min<size_t>({ 256, size, buffer.size() });
+            if (!replaced && checkedSize > 0) {
+                char start[256];
+                replaced = read(stream, 0, start, checkedSize) < checkedSize || std::memcmp(start, buffer.data(), checkedSize) != 0;
+            }
+            if (replaced) {
+                buffer.clear();
+                file.lineStarts.clear();
+                file.indexedSize = 0;
+                ++file.generation;
+            }
+
+            const auto previousSize = buffer.size();
+            const auto count = std::min(size - previousSize, budget);
+            buffer.resize(previousSize + count);
+            // The file may shrink while it's read, in which case the next call notices it
+            buffer.resize(previousSize + read(stream, previousSize, buffer.data() + previousSize, count));
+
+            // Large files are read over several frames
+            tail.changed = buffer.size() < size;
+            file.contents = buffer;
+            return buffer.size() - previousSize;
+        }
+
+        static size_t read(std::ifstream &stream, size_t offset, char *out, size_t count) noexcept {
+            if (count == 0)
+                return 0;
+            stream.clear();
+            stream.seekg(std::streamoff(offset));
+            stream.read(out, std::streamsize(count));
+            return size_t(stream.gcount());
+        }
+
+        // Returns the number of bytes indexed
+        static size_t index(koverlay::TailedFile &file, size_t budget) noexcept {
+            const auto start = file.indexedSize;
+            const auto end = std::min(file.contents.size(), start + budget);
+            if (start == end)
+                return 0;
+
+            if (start == 0)
+                file.lineStarts.push_back(0);
+
+            const auto data = file.contents.data();
+            auto current = data + start;
+            while (const auto newline = (const char *)std::memchr(current, '\n', data + end - current)) {
+                current = newline + 1;
+                file.lineStarts.push_back(current - data);
+            }
+
+            file.indexedSize = end;
+            return end - start;
+        }
+
+        static void registerBindings(sol::state &state) noexcept {
+            state.new_usertype<TailView>("KoverlayTailedFile", sol::no_constructor,
+                "path", sol::property([](const TailView &view) { return view.file->path; }),
+                "size", sol::property([](const TailView &view) { return view.file->contents.size(); }),
+                "lines", sol::property([](const TailView &view) { return view.file->getLineCount(); }),
+                "indexing", sol::property([](const TailView &view) { return view.file->indexedSize < view.file->contents.size(); }),
+                "generation", sol::property([](const TailView &view) { return view.file->generation; }),
+                "line", [](const TailView &view, size_t index) -> sol::optional<std::string> {
+                    if (index < 1 || index > view.file->getLineCount())
+                        return sol::nullopt;
+                    return std::string(view.file->getLine(index - 1));
+                },
+                "show", [](const TailView &view, sol::optional<bool> follow) {
+                    showLines(*view.file, follow.value_or(false));
+                }
+            );
+
+            auto table = state.create_named_table("tail");
+            table["open"] = [](const std::string &path) {
+                return TailView{ open(path) };
+            };
+        }
+
+        // Only draws the visible lines, so it should be called inside a child window (or a window) that only contains them
+        static void showLines(const koverlay::TailedFile &file, bool follow) noexcept {
+            const bool atBottom = ImGui::GetScrollY() >= ImGui::GetScrollMaxY();
+
+            ImGuiListClipper clipper;
+            clipper.Begin((int)file.getLineCount());
+            while (clipper.Step())
+                for (int i = clipper.DisplayStart; i < clipper.DisplayEnd; ++i) {
+                    const auto line = file.getLine(i);
+                    ImGui::TextUnformatted(line.data(), line.data() + line.size());
+                }
+            clipper.End();
+
+            if (follow && atBottom)
+                ImGui::SetScrollHereY(1.f);
+        }
+    };
+}
+
+kengine::EntityCreator * FileTailSystem() noexcept {
+	return impl::init;
+}
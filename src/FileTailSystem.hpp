@@ -0,0 +1,6 @@
+#pragma once
+
+#include "EntityCreator.hpp"
+
+// Follows growing files for tools, through a FileTailerComponent and the Lua `tail` table
+kengine::EntityCreator * FileTailSystem() noexcept;
@@ -1,25 +1,44 @@
 #include "ImGuiLuaSystem.hpp"
 #include "kengine.hpp"
 
+// stl
+#include <algorithm>
+#include <filesystem>
+#include <memory>
+#include <optional>
+#include <stdexcept>
+#include <unordered_map>
+#include <unordered_set>
+
 // kengine data
 #include "data/CommandLineComponent.hpp"
 #include "data/ImGuiScaleComponent.hpp"
 #include "data/ImGuiToolComponent.hpp"
 #include "data/LuaStateComponent.hpp"
-#include "data/NameComponent.hpp"
 
 // kengine functions
 #include "functions/Execute.hpp"
 
 // kengine helpers
 #include "helpers/commandLineHelper.hpp"
+#include "helpers/logHelper.hpp"
 
 // putils
 #include "Directory.hpp"
 
+// api
+#include "ComponentEventsComponent.hpp"
+#include "EnabledToolsComponent.hpp"
+
+// project
+#include "helpers/FileWatcher.hpp"
+#include "helpers/ScriptArchive.hpp"
+#include "helpers/toolBatchHelper.hpp"
+
 namespace {
     struct Options {
         bool printLuaFunctions = false;
+        std::string scriptArchive = "scripts.kpack";
     };
 }
 
@@ -29,6 +48,9 @@ putils_reflection_info{
     putils_reflection_attributes(
         putils_reflection_attribute(printLuaFunctions,
             putils_reflection_metadata("help", "Print a list of all ImGui functions exposed to Lua")
+        ),
+        putils_reflection_attribute(scriptArchive,
+            putils_reflection_metadata("help", "Archive of precompiled scripts built by koverlay-pack, loaded at startup if it exists")
         )
     );
 };
@@ -41,16 +63,51 @@ namespace {
     struct impl {
         static inline sol::state * g_state = nullptr;
 
+        // The scripts directory is only rescanned this often, instead of every frame
+        static constexpr float rescanInterval = 1.f;
+        static inline float timeSinceRescan = rescanInterval;
+
+        struct LuaScriptComponent {
+            std::string path;
+            // Scripts from the archive are loaded once from its mapping, instead of parsing their file every frame
+            const ScriptArchive::Script *packed = nullptr;
+            int functionRef = LUA_NOREF; // in the Lua registry, not a sol reference, so it can outlive the state
+        };
+
+        static inline Options options;
+        static inline ScriptArchive archive;
+        static inline bool archiveToolsAdded = false;
+        // File names of the archive's tools, whose loose copies are skipped so they aren't listed twice
+        static inline std::unordered_set<std::string> packedTools;
+
+        // Modules `require`d from `scripts/lib`, which are all unloaded when any of their files changes,
+        // so that modules requiring each other are reloaded together
+        static constexpr auto libDirectory = "scripts/lib";
+        struct LibModule {
+            std::string name;
+            FileWatcher::ID watch;
+        };
+        static inline std::vector<LibModule> libModules;
+        static inline std::unique_ptr<FileWatcher> libWatcher;
+
         static void init(kengine::Entity &system) noexcept {
+            options = kengine::parseCommandLine<Options>();
             initBindings();
+            libWatcher = std::make_unique<FileWatcher>();
+            addSearcher(searchLib);
+            openArchive();
             system += kengine::functions::Execute{[&](float deltaTime) noexcept {
+                unloadModifiedModules();
+                timeSinceRescan += deltaTime;
+                if (timeSinceRescan >= rescanInterval) {
+                    timeSinceRescan = 0.f;
+                    rescan();
+                }
                 runScripts();
             }};
         }
 
         static void initBindings() noexcept {
-            const auto options = kengine::parseCommandLine<Options>();
-
             for (const auto &[e, state]: kengine::entities.with<kengine::LuaStateComponent>()) {
                 lState = *state.state;
                 LoadImguiBindings();
@@ -66,19 +123,181 @@ end
             }
         }
 
-        static void runScripts() noexcept {
-            (*g_state)["IMGUI_SCALE"] = getScale();
+        static void openArchive() noexcept {
+            std::error_code ec;
+            if (!std::filesystem::exists(options.scriptArchive, ec))
+                return;
+
+            archive = ScriptArchive(options.scriptArchive.c_str());
+            if (!archive) {
+                kengine_logf(Error, "Lua", "Failed to open %s: %s", options.scriptArchive.c_str(), archive.getError().c_str());
+                archive = {};
+                return;
+            }
+            if (archive.getLuaVersion() != LUA_VERSION_NUM) {
+                kengine_logf(Error, "Lua", "%s was built for Lua %u, but the overlay uses Lua %d", options.scriptArchive.c_str(), archive.getLuaVersion(), LUA_VERSION_NUM);
+                archive = {};
+                return;
+            }
+
+            // Added last, so packed modules take precedence over loose files
+            addSearcher(searchArchive);
+        }
+
+        // Inserts `searcher` right after `package.preload`'s, so it runs before Lua's default ones
+        static void addSearcher(lua_CFunction searcher) noexcept {
+            sol::table searchers = (*g_state)["package"]["searchers"];
+            for (auto i = searchers.size(); i >= 2; --i)
+                searchers[i + 1] = searchers[i];
+            searchers[2] = searcher;
+        }
+
+        // Searchers push their results, or an error message and return -1, which is only raised once their strings are destroyed,
+        // as Lua errors skip C++ destructors
+        // None of them are noexcept: Lua errors are exceptions when Lua is built as C++, raised by lua_error but also by
+        // luaL_checkstring, and by any push or load that runs out of memory
+        static int searchArchive(lua_State *L) {
+            const auto results = findInArchive(L, luaL_checkstring(L, 1));
+            return results >= 0 ? results : lua_error(L);
+        }
+
+        static int findInArchive(lua_State *L, const char *name) {
+            const auto module = archive.findModule(name);
+            if (!module) {
+                lua_pushfstring(L, "\n\tno module '%s' in %s", name, options.scriptArchive.c_str());
+                return 1;
+            }
+
+            const auto chunkName = options.scriptArchive + ':' + module->name;
+            if (!ScriptArchive::isIntact(*module)) {
+                lua_pushfstring(L, "%s is corrupted", chunkName.c_str());
+                return -1;
+            }
+            if (luaL_loadbufferx(L, module->chunk.data(), module->chunk.size(), ('@' + chunkName).c_str(), "b") != LUA_OK)
+                return -1;
+            lua_pushstring(L, chunkName.c_str());
+            return 2;
+        }
+
+        static int searchLib(lua_State *L) {
+            const auto results = findInLib(L, luaL_checkstring(L, 1));
+            return results >= 0 ? results : lua_error(L);
+        }
+
+        // "format.numbers" is `scripts/lib/format/numbers.lua`, compiled once and then served from `package.loaded` until it changes
+        static int findInLib(lua_State *L, const char *name) {
+            std::string path = name;
+            std::ranges::replace(path, '.', '/');
+            path = std::string(libDirectory) + '/' + path + ".lua";
+
+            std::error_code ec;
+            if (!std::filesystem::is_regular_file(path, ec)) {
+                lua_pushfstring(L, "\n\tno file '%s'", path.c_str());
+                return 1;
+            }
+            if (luaL_loadfilex(L, path.c_str(), "t") != LUA_OK)
+                return -1;
+
+            // Watched even if it fails to run, so fixing it reloads the modules that require it
+            if (std::ranges::find(libModules, std::string_view(name), &LibModule::name) == libModules.end())
+                libModules.push_back({ name, libWatcher->add(path) });
+            lua_pushstring(L, path.c_str());
+            return 2;
+        }
+
+        static void unloadModifiedModules() noexcept {
+            bool modified = false;
+            libWatcher->poll([&](FileWatcher::ID) noexcept {
+                modified = true;
+            });
+            if (!modified)
+                return;
+
+            sol::table loaded = (*g_state)["package"]["loaded"];
+            for (const auto &module: libModules) {
+                loaded[module.name] = sol::lua_nil;
+                libWatcher->remove(module.watch);
+            }
+            kengine_logf(Log, "Lua", "Reloading %zu modules from %s", libModules.size(), libDirectory);
+            libModules.clear();
+        }
+
+        // Loose scripts' tools, removed once their file is gone so a deleted or renamed script stops running
+        struct KnownScript {
+            kengine::EntityID id = kengine::INVALID_ID;
+            size_t lastSeen = 0; // rescan in which the file was last found
+        };
+        static inline std::unordered_map<std::string, KnownScript> knownScripts;
+        static inline size_t rescanCount = 0;
+
+        static void rescan() noexcept {
+            static std::vector<toolBatchHelper::Tool> tools;
+            static std::vector<LuaScriptComponent> scripts;
+            tools.clear();
+            scripts.clear();
+            ++rescanCount;
+
+            if (!archiveToolsAdded) {
+                archiveToolsAdded = true;
+                for (const auto &script: archive.getScripts())
+                    if (script.kind == ScriptArchive::Kind::Tool) {
+                        packedTools.insert(script.name);
+                        tools.push_back(toolBatchHelper::fromManifest(ToolManifest{ script.manifest }));
+                        scripts.push_back({ .path = options.scriptArchive + ':' + script.name, .packed = &script });
+                    }
+            }
 
             putils::Directory d("scripts");
 
             d.for_each([&](const putils::Directory::File &f) {
                 const auto view = std::string_view(f.name);
                 const auto dot = view.find_last_of('.');
-                if (!f.isDirectory && dot != std::string_view::npos && view.substr(dot) == ".lua")
-                    runScript(f.fullPath.c_str());
+                if (f.isDirectory || dot == std::string_view::npos || view.substr(dot) != ".lua")
+                    return;
+                if (packedTools.contains(std::string(view)))
+                    return;
+
+                std::string path = f.fullPath.c_str();
+                auto &known = knownScripts[path];
+                const bool isNew = known.lastSeen == 0;
+                known.lastSeen = rescanCount;
+                if (!isNew)
+                    return;
+                tools.push_back(readToolHeader(path));
+                scripts.push_back({ .path = std::move(path) });
+            });
+
+            std::erase_if(knownScripts, [](const auto &entry) noexcept {
+                const auto &[path, known] = entry;
+                if (known.lastSeen == rescanCount)
+                    return false;
+                kengine_logf(Log, "Lua", "%s was removed, removing its tool", path.c_str());
+                if (known.id != kengine::INVALID_ID)
+                    kengine::entities -= known.id;
+                return true;
+            });
+
+            toolBatchHelper::createTools(tools, [](kengine::Entity &e, size_t i) {
+                knownScripts[scripts[i].path].id = e.id;
+                e += std::move(scripts[i]);
             });
         }
 
+        static void runScripts() noexcept {
+            (*g_state)["IMGUI_SCALE"] = getScale();
+
+            // Copied, as scripts may disable their tool
+            static std::vector<kengine::EntityID> toRun;
+            const auto enabledTools = koverlay::getEnabledTools();
+            toRun.assign(enabledTools.begin(), enabledTools.end());
+
+            for (const auto id: toRun) {
+                auto e = kengine::entities[id];
+                if (const auto script = e.tryGet<LuaScriptComponent>())
+                    runScript(e, *script);
+            }
+        }
+
         static float getScale() noexcept {
             float scale = 1.f;
             for (const auto &[e, comp]: kengine::entities.with<kengine::ImGuiScaleComponent>())
@@ -86,42 +305,72 @@ end
             return scale;
         }
 
-        static void runScript(const char *script) noexcept {
-            auto e = getEntityForScript(script);
+        static void runScript(kengine::Entity &e, LuaScriptComponent &script) noexcept {
             auto &tool = e.get<kengine::ImGuiToolComponent>();
 
-            if (!tool.enabled)
-                return;
-
             (*g_state)["TOOL_ENABLED"] = tool.enabled;
             try {
-                g_state->script_file(script);
+                if (!script.packed)
+                    g_state->script_file(script.path);
+                else
+                    runPacked(script);
             }
             catch (const std::exception &e) {
                 std::cerr << e.what() << std::endl;
             }
-            tool.enabled = (*g_state)["TOOL_ENABLED"];
+            const bool enabled = (*g_state)["TOOL_ENABLED"];
+            if (enabled != tool.enabled) {
+                tool.enabled = enabled;
+                koverlay::componentEvents::notifyModified<kengine::ImGuiToolComponent>(e);
+            }
         }
 
-        static kengine::Entity getEntityForScript(const char *script) noexcept {
-            static std::unordered_map<std::string, kengine::EntityID> ids;
+        static void runPacked(LuaScriptComponent &script) {
+            const auto L = g_state->lua_state();
+            const auto popError = [&]() {
+                std::string error = lua_tostring(L, -1);
+                lua_pop(L, 1);
+                return std::runtime_error(error);
+            };
 
-            const auto it = ids.find(script);
-            if (it != ids.end())
-                return kengine::entities[it->second];
+            if (script.functionRef == LUA_NOREF) {
+                if (!ScriptArchive::isIntact(*script.packed))
+                    throw std::runtime_error(script.path + " is corrupted");
+                const auto &chunk = script.packed->chunk;
+                if (luaL_loadbufferx(L, chunk.data(), chunk.size(), ('@' + script.path).c_str(), "b") != LUA_OK)
+                    throw popError();
+                script.functionRef = luaL_ref(L, LUA_REGISTRYINDEX);
+            }
 
-            return kengine::entities.create([&](kengine::Entity &e) {
-                ids[script] = e.id;
-                try {
-                    g_state->script_file(script);
-                }
-                catch (const std::exception &e) {
-                    std::cerr << e.what() << std::endl;
-                }
-                e += kengine::ImGuiToolComponent{(*g_state)["TOOL_ENABLED"]};
-                const std::string name = (*g_state)["TOOL_NAME"];
-                e += kengine::NameComponent{name};
-            });
+            lua_rawgeti(L, LUA_REGISTRYINDEX, script.functionRef);
+            if (lua_pcall(L, 0, 0, 0) != LUA_OK)
+                throw popError();
+        }
+
+        // Reads the script's manifest (a `.tool.json` sidecar or a `-- @name` comment header),
+        // or its top-level `TOOL_NAME = "..."` (and optional `TOOL_ENABLED = true`) assignments, without running it
+        // Scripts that compute their name are run once instead
+        static toolBatchHelper::Tool readToolHeader(const std::string &script) noexcept {
+            if (auto manifest = toolManifestHelper::readSidecar(script))
+                return toolBatchHelper::fromManifest(std::move(*manifest));
+            if (auto manifest = toolManifestHelper::readLuaHeader(script))
+                return toolBatchHelper::fromManifest(std::move(*manifest));
+
+            if (auto assignments = toolManifestHelper::readLuaAssignments(script))
+                return { std::move(assignments->name), assignments->enabled };
+
+            toolBatchHelper::Tool tool;
+
+            (*g_state)["TOOL_NAME"] = sol::lua_nil;
+            try {
+                g_state->script_file(script);
+            }
+            catch (const std::exception &e) {
+                std::cerr << e.what() << std::endl;
+            }
+            tool.enabled = (*g_state)["TOOL_ENABLED"];
+            tool.name = (*g_state)["TOOL_NAME"].get_or<std::string>(script);
+            return tool;
         }
     };
 }
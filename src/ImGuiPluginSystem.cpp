@@ -1,53 +1,620 @@
 #include "ImGuiPluginSystem.hpp"
-#include "PluginManager.hpp"
 #include "kengine.hpp"
 
+// stl
+#include <chrono>
+#include <filesystem>
+#include <map>
+#include <memory>
+#include <unordered_set>
+#include <vector>
+
+#ifdef _WIN32
+# include <process.h>
+#else
+# include <stdlib.h>
+#endif
+
 // kengine data
-#include "data/NameComponent.hpp"
 #include "data/ImGuiScaleComponent.hpp"
 #include "data/ImGuiToolComponent.hpp"
+#include "data/NameComponent.hpp"
 
 // kengine functions
 #include "functions/Execute.hpp"
 
+// kengine helpers
+#include "helpers/commandLineHelper.hpp"
+#include "helpers/logHelper.hpp"
+
+// putils
+#include "Directory.hpp"
+
+// imgui
+#include "imgui.h"
+
+// api
+#include "ComponentEventsComponent.hpp"
+#include "EnabledToolsComponent.hpp"
+#include "ImGuiABI.hpp"
+#include "JobsComponent.hpp"
+#include "ProfilerSectionComponent.hpp"
+#include "ToolIndexComponent.hpp"
+#include "ToolMetadataComponent.hpp"
+
+// project
+#include "helpers/ImGuiContextGroup.hpp"
+#include "helpers/SandboxedPlugin.hpp"
+#include "helpers/SharedLibrary.hpp"
+#include "helpers/staticPlugins.hpp"
+#include "helpers/toolBatchHelper.hpp"
+#include "helpers/toolManifestHelper.hpp"
 
 struct ImGuiContext;
 extern ImGuiContext * GImGui;
 
+namespace {
+    struct Options {
+        bool lazyPlugins = true;
+        float pluginUnloadDelay = 0.f;
+        bool hotReloadPlugins = false;
+        bool sandboxPlugins = false;
+        bool parallelPlugins = false;
+    };
+}
+
+#define refltype Options
+putils_reflection_info{
+    putils_reflection_custom_class_name(Plugins);
+    putils_reflection_attributes(
+        putils_reflection_attribute(lazyPlugins,
+            putils_reflection_metadata("help", "Only load plugins that have a manifest once their tool is enabled")
+        ),
+        putils_reflection_attribute(pluginUnloadDelay,
+            putils_reflection_metadata("help", "Seconds after which a disabled ImGui plugin is unloaded (0 to keep them loaded)")
+        ),
+        putils_reflection_attribute(hotReloadPlugins,
+            putils_reflection_metadata("help", "Reload ImGui plugins when they are rebuilt (meant for development)")
+        ),
+        putils_reflection_attribute(sandboxPlugins,
+            putils_reflection_metadata("help", "Run ImGui plugins that have a manifest in a separate process")
+        ),
+        putils_reflection_attribute(parallelPlugins,
+            putils_reflection_metadata("help", "Draw ImGui plugins in parallel, with one ImGui context per tool category")
+        )
+    );
+};
+#undef refltype
+
 namespace {
     struct impl {
-        static inline putils::PluginManager pm;
+        // The plugins directory is only rescanned this often, instead of every frame
+        static constexpr float rescanInterval = 1.f;
+
+        using GetNameAndEnabledFunc = const char * (bool **);
+        using DrawImGuiFunc = void (ImGuiContext &, float);
+        using LoadKenginePluginFunc = void (void *);
+        // Optional exports used to keep a plugin's state across reloads
+        // `serializeState` returns the size it needs, and only writes to `buffer` if `size` is large enough
+        using SerializeStateFunc = size_t (char * buffer, size_t size);
+        using RestoreStateFunc = void (const char * buffer, size_t size);
+        // Optional export called before the plugin's library is unloaded or replaced by a new version, so it can release what
+        // points into its code, e.g. its component event subscriptions
+        using UnloadPluginFunc = void ();
+        // Optional export giving the plugin access to the overlay's job system
+        using SetJobsFunc = void (const koverlay::Jobs * jobs);
+        // Describes the ImGui the plugin was built with. Plugins built before it was added aren't checked
+        using GetImGuiABIFunc = void (koverlay::ImGuiABI * abi);
+
+        // Draw lists built during a frame may hold callbacks into a plugin until they are rendered,
+        // so replaced libraries are kept loaded for a few more frames
+        static constexpr int retiredLibraryFrames = 3;
+
+        // Plugins with a manifest are only loaded once their tool is enabled
+        struct PluginComponent {
+            std::string path;
+            std::shared_ptr<SharedLibrary> library = nullptr;
+            bool *enabled = nullptr;
+            DrawImGuiFunc *drawImGui = nullptr;
+            float disabledTime = 0.f;
+            // Uses the overlay's ImGui and its `GImGui`, so it can only be drawn from the thread that draws the overlay
+            bool sharedImGui = false;
+            // Linked into the executable (see staticPlugins.hpp), so never loaded, reloaded or unloaded
+            bool linked = false;
+
+            // Libraries are loaded from a copy when hot reload is enabled, so the original can be rebuilt
+            std::string shadowPath;
+            std::filesystem::file_time_type loadedTime{};
+            std::filesystem::file_time_type observedTime{};
+            size_t version = 0;
+
+            // Sandboxed plugins are never loaded by the overlay, but by a `koverlay-plugin-host` process
+            bool sandboxed = false;
+            std::shared_ptr<SandboxedPlugin> sandbox = nullptr;
+        };
+
+        // Plugins of a category, drawn into their own ImGui context when the `parallelPlugins` option is set
+        struct PluginGroup {
+            explicit PluginGroup(const std::string &name) noexcept : context(name) {}
+
+            ImGuiContextGroup context;
+            std::vector<std::pair<kengine::EntityID, PluginComponent *>> toDraw;
+            float drawTime = 0.f; // smoothed, in milliseconds
+        };
+
+        struct RetiredLibrary {
+            std::shared_ptr<SharedLibrary> library;
+            std::string shadowPath;
+            int framesLeft;
+        };
+
+        static inline Options options;
+        static inline std::unordered_set<std::string> knownFiles;
+        static inline float timeSinceRescan = rescanInterval;
+        static inline std::vector<RetiredLibrary> retiredLibraries;
+
+        // Private to this process, created on the first copy and removed on exit
+        static inline struct ShadowDirectory {
+            std::filesystem::path path;
+            bool created = false;
+
+            ~ShadowDirectory() noexcept {
+                std::error_code ec;
+                if (!path.empty())
+                    std::filesystem::remove_all(path, ec); // libraries still loaded on Windows stay behind
+            }
+        } shadowDirectory;
+        static inline std::map<std::string, std::unique_ptr<PluginGroup>> groups;
+
+        // kengine plugins are never unloaded, as their entities may point into their code
+        static inline std::vector<SharedLibrary> kenginePlugins;
+        static inline bool kenginePluginsLoaded = false;
+        // Placeholder tools for lazy kengine plugins, replaced at the start of the next frame
+        static inline std::vector<kengine::EntityID> kenginePluginsToLoad;
 
         static void init(kengine::Entity &system) noexcept {
+            options = kengine::parseCommandLine<Options>();
+
             system += kengine::functions::Execute{execute};
-        }
+            if (options.parallelPlugins)
+                system += koverlay::ProfilerSectionComponent{ "Plugin groups", drawGroupTimes };
 
-        struct PluginEnabledPointerComponent {
-            bool *enabled;
-        };
+            koverlay::componentEvents::subscribe<kengine::ImGuiToolComponent>({
+                .onModified = onToolModified
+            });
+        }
 
         static void execute(float deltaTime) noexcept {
-            bool *enabled;
-            const auto names = pm.rescanDirectoryWithReturn<1, const char *>("plugins", "getNameAndEnabled", &enabled);
-            for (const auto &name: names) {
-                kengine::entities += [&](kengine::Entity &e) {
-                    e += kengine::NameComponent{name};
-                    e += PluginEnabledPointerComponent{enabled};
-                    e += kengine::ImGuiToolComponent{*enabled};
-                };
+            releaseRetiredLibraries();
+            loadPendingKenginePlugins();
+
+            timeSinceRescan += deltaTime;
+            if (timeSinceRescan >= rescanInterval) {
+                unloadDisabledPlugins(timeSinceRescan);
+                timeSinceRescan = 0.f;
+                reloadModifiedPlugins();
+                rescan();
             }
 
             drawImGui();
         }
 
+        template<typename Func>
+        static void forEachLibrary(Func &&func) noexcept {
+            putils::Directory d("plugins");
+            d.for_each([&](const putils::Directory::File &f) {
+                const auto view = std::string_view(f.name);
+                const auto dot = view.find_last_of('.');
+                if (f.isDirectory || dot == std::string_view::npos || view.substr(dot) != SharedLibrary::extension)
+                    return;
+                func(std::string(f.fullPath.c_str()));
+            });
+        }
+
+        static void loadKenginePlugins() noexcept {
+            for (const auto load: staticPlugins::kenginePlugins)
+                load(kengine::getState());
+            addStaticImGuiPlugins();
+
+            forEachLibrary([](const std::string &path) {
+                if (options.lazyPlugins && toolManifestHelper::readSidecar(path)) // listed by `rescan`, loaded once enabled
+                    return;
+
+                SharedLibrary library(path.c_str());
+                if (const auto load = library.getFunction<LoadKenginePluginFunc>("loadKenginePlugin")) {
+                    load(kengine::getState());
+                    kenginePlugins.push_back(std::move(library));
+                    knownFiles.insert(path);
+                }
+            });
+            kenginePluginsLoaded = true;
+        }
+
+        static void addStaticImGuiPlugins() noexcept {
+            std::vector<toolBatchHelper::Tool> tools;
+            std::vector<PluginComponent> plugins;
+            for (const auto functions: staticPlugins::imguiPlugins) {
+                PluginComponent plugin{ .drawImGui = functions->drawImGui, .sharedImGui = true, .linked = true };
+                functions->setJobs(koverlay::getJobs());
+                const auto name = functions->getNameAndEnabled(&plugin.enabled);
+                tools.push_back({ name, *plugin.enabled });
+                plugins.push_back(std::move(plugin));
+            }
+
+            toolBatchHelper::createTools(tools, [&](kengine::Entity &e, size_t i) {
+                e += plugins[i];
+            });
+        }
+
+        static void rescan() noexcept {
+            // Avoids loading a copy of a kengine plugin before it's been loaded
+            if (!kenginePluginsLoaded)
+                return;
+
+            static std::vector<toolBatchHelper::Tool> tools;
+            static std::vector<PluginComponent> plugins;
+            tools.clear();
+            plugins.clear();
+
+            forEachLibrary([&](const std::string &path) {
+                if (!knownFiles.insert(path).second)
+                    return;
+
+                auto manifest = toolManifestHelper::readSidecar(path);
+                if (manifest && (options.lazyPlugins || manifest->sandbox || options.sandboxPlugins)) {
+                    const bool sandboxed = manifest->sandbox || options.sandboxPlugins;
+                    tools.push_back(toolBatchHelper::fromManifest(std::move(*manifest)));
+                    plugins.push_back({ .path = path, .sandboxed = sandboxed });
+                    return;
+                }
+
+                PluginComponent plugin{ .path = path };
+                const auto name = load(plugin);
+                if (!name) // not an ImGui plugin, probably a kengine plugin
+                    return;
+                if (manifest)
+                    tools.push_back(toolBatchHelper::fromManifest(std::move(*manifest)));
+                else
+                    tools.push_back({ name, *plugin.enabled });
+                plugins.push_back(std::move(plugin));
+            });
+
+            toolBatchHelper::createTools(tools, [](kengine::Entity &e, size_t i) {
+                e += plugins[i];
+            });
+        }
+
+        // Returns the plugin's name, or nullptr if it isn't an ImGui plugin
+        // The library is kept in `plugin` either way, so it can be checked for `loadKenginePlugin`
+        static const char * load(PluginComponent &plugin) noexcept {
+            std::error_code ec;
+            plugin.loadedTime = plugin.observedTime = std::filesystem::last_write_time(plugin.path, ec);
+            ++plugin.version; // previous copies may still be loaded
+            plugin.shadowPath = options.hotReloadPlugins ? makeShadowCopy(plugin) : plugin.path;
+
+            plugin.library = std::make_shared<SharedLibrary>(plugin.shadowPath.c_str());
+#ifndef _WIN32
+            // The mapping stays valid once the file is removed
+            if (plugin.shadowPath != plugin.path)
+                std::filesystem::remove(plugin.shadowPath, ec);
+#endif
+            const auto getNameAndEnabled = plugin.library->getFunction<GetNameAndEnabledFunc>("getNameAndEnabled");
+            const auto draw = plugin.library->getFunction<DrawImGuiFunc>("drawImGui");
+            if (!getNameAndEnabled || !draw)
+                return nullptr;
+
+            if (const auto getImGuiABI = plugin.library->getFunction<GetImGuiABIFunc>("getImGuiABI")) {
+                koverlay::ImGuiABI abi;
+                getImGuiABI(&abi);
+                if (!abi.isCompatibleWith(koverlay::ImGuiABI{})) {
+                    kengine_logf(Error, "Plugins", "%s was built with ImGui %d, but the overlay uses ImGui %d (or a different configuration of it)",
+                        plugin.path.c_str(), abi.version, IMGUI_VERSION_NUM);
+                    return nullptr;
+                }
+                plugin.sharedImGui = abi.shared;
+            }
+#ifdef KOVERLAY_INTERPOSES_IMGUI
+            // The executable exports ImGui and comes first in symbol lookup (RTLD_LOCAL only hides plugins from each other), so plugins
+            // built with their own copy still call the executable's, and share its `GImGui` like those built to use it
+            plugin.sharedImGui = true;
+#endif
+
+            plugin.drawImGui = draw;
+            if (const auto setJobs = plugin.library->getFunction<SetJobsFunc>("setJobs"))
+                setJobs(koverlay::getJobs());
+            return getNameAndEnabled(&plugin.enabled);
+        }
+
+        // Copies are loaded as code, so they go to a directory that no other user can predict or write to
+        // Empty if it couldn't be created
+        static const std::filesystem::path &getShadowDirectory() noexcept {
+            if (shadowDirectory.created)
+                return shadowDirectory.path;
+            shadowDirectory.created = true;
+
+            std::error_code ec;
+            const auto temp = std::filesystem::temp_directory_path(ec);
+            if (ec)
+                return shadowDirectory.path;
+#ifdef _WIN32
+            // The temporary directory is already per-user. Fails if the directory exists, e.g. left by a process with the same ID
+            const auto path = temp / ("koverlay-plugins-" + std::to_string(_getpid()));
+            if (std::filesystem::create_directory(path, ec))
+                shadowDirectory.path = path;
+#else
+            // Random name, created with mode 0700, and fails rather than reusing an existing directory
+            auto path = (temp / "koverlay-plugins-XXXXXX").string();
+            if (mkdtemp(path.data()))
+                shadowDirectory.path = path;
+#endif
+            return shadowDirectory.path;
+        }
+
+        static std::string makeShadowCopy(const PluginComponent &plugin) noexcept {
+            const std::filesystem::path original = plugin.path;
+            const auto &directory = getShadowDirectory();
+            if (directory.empty()) {
+                kengine_logf(Warning, "Plugins", "Failed to create a directory for plugin copies, %s won't be reloadable", plugin.path.c_str());
+                return plugin.path;
+            }
+
+            auto shadow = directory / original.stem();
+            shadow += '.' + std::to_string(plugin.version);
+            shadow += original.extension();
+
+            std::error_code ec;
+            std::filesystem::copy_file(original, shadow, std::filesystem::copy_options::overwrite_existing, ec);
+            if (ec) {
+                kengine_logf(Warning, "Plugins", "Failed to copy %s, it won't be reloadable: %s", plugin.path.c_str(), ec.message().c_str());
+                return plugin.path;
+            }
+            return shadow.string();
+        }
+
+        static void retire(PluginComponent &plugin) noexcept {
+            if (plugin.library) {
+                if (const auto unloadPlugin = plugin.library->getFunction<UnloadPluginFunc>("unloadPlugin"))
+                    unloadPlugin();
+                retiredLibraries.push_back({ std::move(plugin.library), std::move(plugin.shadowPath), retiredLibraryFrames });
+            }
+            plugin.library = nullptr;
+            plugin.shadowPath.clear();
+            plugin.enabled = nullptr;
+            plugin.drawImGui = nullptr;
+        }
+
+        static void releaseRetiredLibraries() noexcept {
+            std::erase_if(retiredLibraries, [](RetiredLibrary &retired) noexcept {
+                if (--retired.framesLeft > 0)
+                    return false;
+                retired.library = nullptr;
+#ifdef _WIN32
+                std::error_code ec;
+                std::filesystem::remove(retired.shadowPath, ec);
+#endif
+                return true;
+            });
+        }
+
+        // A plugin is reloaded once its file has stopped changing for a full rescan interval,
+        // so a library that's still being written isn't loaded
+        static void reloadModifiedPlugins() noexcept {
+            if (!options.hotReloadPlugins)
+                return;
+
+            for (const auto &[e, plugin, tool]: kengine::entities.with<PluginComponent, kengine::ImGuiToolComponent>()) {
+                if (!plugin.drawImGui || plugin.linked || plugin.shadowPath == plugin.path) // not loaded (will load the latest version), or not reloadable
+                    continue;
+
+                std::error_code ec;
+                const auto time = std::filesystem::last_write_time(plugin.path, ec);
+                if (ec || time == plugin.loadedTime)
+                    continue;
+                if (time != plugin.observedTime) {
+                    plugin.observedTime = time;
+                    continue;
+                }
+                reload(plugin, tool);
+            }
+        }
+
+        static void reload(PluginComponent &plugin, const kengine::ImGuiToolComponent &tool) noexcept {
+            std::string state;
+            if (const auto serializeState = plugin.library->getFunction<SerializeStateFunc>("serializeState")) {
+                state.resize(serializeState(nullptr, 0));
+                state.resize(serializeState(state.data(), state.size()));
+            }
+
+            PluginComponent next{ .path = plugin.path, .version = plugin.version };
+            if (!load(next)) {
+                kengine_logf(Error, "Plugins", "Failed to reload %s, keeping the previous version", plugin.path.c_str());
+                plugin.loadedTime = next.loadedTime; // don't retry until it's rebuilt again
+                return;
+            }
+
+            if (const auto restoreState = next.library->getFunction<RestoreStateFunc>("restoreState"))
+                restoreState(state.data(), state.size());
+            *next.enabled = tool.enabled;
+            next.disabledTime = plugin.disabledTime;
+
+            retire(plugin);
+            plugin = std::move(next);
+            kengine_logf(Log, "Plugins", "Reloaded %s (version %zu)", plugin.path.c_str(), plugin.version);
+        }
+
+        static void onToolModified(kengine::Entity &e, kengine::ImGuiToolComponent &tool) noexcept {
+            const auto plugin = e.tryGet<PluginComponent>();
+            if (!plugin)
+                return;
+
+            if (plugin->sandboxed) {
+                if (!tool.enabled)
+                    plugin->sandbox = nullptr;
+                else if (!plugin->sandbox)
+                    plugin->sandbox = std::make_shared<SandboxedPlugin>(plugin->path);
+                return;
+            }
+
+            plugin->disabledTime = 0.f;
+            if (!plugin->drawImGui) {
+                if (!tool.enabled || plugin->library) // disabled, or a kengine plugin already waiting to be loaded
+                    return;
+                if (!load(*plugin)) {
+                    if (plugin->library->getFunction<LoadKenginePluginFunc>("loadKenginePlugin")) {
+                        // The plugin creates its own tool, which replaces this entity
+                        kenginePluginsToLoad.push_back(e.id);
+                        return;
+                    }
+                    kengine_logf(Error, "Plugins", "%s has a manifest but isn't a plugin", plugin->path.c_str());
+                    e.detach<PluginComponent>();
+                    tool.enabled = false;
+                    koverlay::componentEvents::notifyModified<kengine::ImGuiToolComponent>(e);
+                    return;
+                }
+            }
+            *plugin->enabled = tool.enabled;
+        }
+
+        static void loadPendingKenginePlugins() noexcept {
+            for (const auto id: kenginePluginsToLoad) {
+                auto e = kengine::entities[id];
+                const std::string name = e.get<kengine::NameComponent>().name.c_str();
+                auto library = std::move(*e.get<PluginComponent>().library);
+                kengine::entities -= id;
+
+                library.getFunction<LoadKenginePluginFunc>("loadKenginePlugin")(kengine::getState());
+                kenginePlugins.push_back(std::move(library));
+
+                for (const auto &entry: koverlay::getSortedTools()) {
+                    if (std::string_view(entry.name.c_str()) != name)
+                        continue;
+                    auto tool = kengine::entities[entry.id];
+                    tool.get<kengine::ImGuiToolComponent>().enabled = true;
+                    koverlay::componentEvents::notifyModified<kengine::ImGuiToolComponent>(tool);
+                }
+            }
+            kenginePluginsToLoad.clear();
+        }
+
+        static void unloadDisabledPlugins(float elapsed) noexcept {
+            if (options.pluginUnloadDelay <= 0.f)
+                return;
+
+            for (const auto &[e, plugin, tool]: kengine::entities.with<PluginComponent, kengine::ImGuiToolComponent>()) {
+                if (!plugin.drawImGui || plugin.linked || tool.enabled)
+                    continue;
+                plugin.disabledTime += elapsed;
+                if (plugin.disabledTime < options.pluginUnloadDelay)
+                    continue;
+                retire(plugin);
+                plugin.disabledTime = 0.f;
+            }
+        }
+
         static void drawImGui() noexcept {
-            for (const auto &[e, enabled, tool]: kengine::entities.with<PluginEnabledPointerComponent, kengine::ImGuiToolComponent>())
-                *enabled.enabled = tool.enabled;
+            static std::vector<kengine::EntityID> toDraw;
+            static std::vector<kengine::EntityID> closed;
 
-            pm.execute("drawImGui", *GImGui, getScale());
+            const auto enabledTools = koverlay::getEnabledTools();
+            toDraw.assign(enabledTools.begin(), enabledTools.end());
+            closed.clear();
 
-            for (const auto &[e, enabled, tool]: kengine::entities.with<PluginEnabledPointerComponent, kengine::ImGuiToolComponent>())
-                tool.enabled = *enabled.enabled;
+            auto &context = *GImGui;
+            const auto scale = getScale();
+            for (const auto id: toDraw) {
+                auto e = kengine::entities[id];
+                auto plugin = e.tryGet<PluginComponent>();
+                if (!plugin)
+                    continue;
+
+                // Enabled without a notification, e.g. by its manifest
+                if (!plugin->drawImGui && !plugin->sandbox) {
+                    onToolModified(e, e.get<kengine::ImGuiToolComponent>());
+                    plugin = e.tryGet<PluginComponent>();
+                    if (!plugin)
+                        continue;
+                }
+
+                if (plugin->sandbox) {
+                    if (!plugin->sandbox->draw(e.get<kengine::NameComponent>().name.c_str(), scale))
+                        closed.push_back(id);
+                }
+                else if (plugin->drawImGui) {
+                    if (options.parallelPlugins && !plugin->sharedImGui) {
+                        getGroup(e).toDraw.emplace_back(id, plugin);
+                        continue;
+                    }
+                    plugin->drawImGui(context, scale);
+                    if (!*plugin->enabled)
+                        closed.push_back(id);
+                }
+            }
+            drawGroups(scale, closed);
+
+            for (const auto id: closed) {
+                auto e = kengine::entities[id];
+                e.get<kengine::ImGuiToolComponent>().enabled = false;
+                koverlay::componentEvents::notifyModified<kengine::ImGuiToolComponent>(e);
+            }
+        }
+
+        static PluginGroup &getGroup(const kengine::Entity &e) noexcept {
+            const auto metadata = e.tryGet<koverlay::ToolMetadataComponent>();
+            const auto name = metadata && !metadata->category.empty() ? metadata->category : std::string("Plugins");
+
+            auto &group = groups[name];
+            if (!group)
+                group = std::make_unique<PluginGroup>(name);
+            return *group;
+        }
+
+        // Only plugins' own code runs on job threads: they each link their own copy of ImGui, so groups only share the
+        // overlay's font atlas, which isn't modified during a frame. The overlay's ImGui is only used from this thread
+        static void drawGroups(float scale, std::vector<kengine::EntityID> &closed) noexcept {
+            static std::vector<PluginGroup *> toDraw;
+            toDraw.clear();
+            for (const auto &[name, group]: groups)
+                if (!group->toDraw.empty()) {
+                    group->context.beginFrame();
+                    toDraw.push_back(group.get());
+                }
+
+            koverlay::jobs::parallelFor(koverlay::getJobs(), toDraw.size(), [scale](size_t begin, size_t end) noexcept {
+                for (auto i = begin; i < end; ++i) {
+                    auto &group = *toDraw[i];
+                    const auto start = std::chrono::steady_clock::now();
+                    for (const auto &[id, plugin]: group.toDraw)
+                        plugin->drawImGui(group.context.getContext(), scale);
+                    const auto time = std::chrono::duration<float, std::milli>(std::chrono::steady_clock::now() - start).count();
+                    group.drawTime += (time - group.drawTime) * .05f;
+                }
+            });
+
+            for (const auto group: toDraw) {
+                group->context.endFrame();
+                for (const auto &[id, plugin]: group->toDraw)
+                    if (!*plugin->enabled)
+                        closed.push_back(id);
+                group->toDraw.clear();
+            }
+        }
+
+        static void drawGroupTimes() noexcept {
+            if (!ImGui::BeginTable("Plugin groups", 2, ImGuiTableFlags_Borders | ImGuiTableFlags_RowBg))
+                return;
+
+            ImGui::TableSetupColumn("Group");
+            ImGui::TableSetupColumn("Draw time");
+            ImGui::TableHeadersRow();
+
+            for (const auto &[name, group]: groups) {
+                ImGui::TableNextRow();
+                ImGui::TableNextColumn();
+                ImGui::TextUnformatted(name.c_str());
+                ImGui::TableNextColumn();
+                ImGui::Text("%.2f ms", group->drawTime);
+            }
+            ImGui::EndTable();
         }
 
         static float getScale() noexcept {
@@ -61,4 +628,8 @@ namespace {
 
 kengine::EntityCreator * ImGuiPluginSystem() noexcept {
 	return impl::init;
-}
\ No newline at end of file
+}
+
+void loadKenginePlugins() noexcept {
+    impl::loadKenginePlugins();
+}
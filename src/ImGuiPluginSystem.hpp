@@ -3,3 +3,7 @@
 #include "EntityCreator.hpp"
 
 kengine::EntityCreator * ImGuiPluginSystem() noexcept;
+
+// Loads the kengine plugins found in the `plugins` directory, and those linked into the executable
+// Plugins with a manifest are only listed, and loaded once their tool is enabled (unless the `lazyPlugins` option is disabled)
+void loadKenginePlugins() noexcept;
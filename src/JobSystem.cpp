@@ -0,0 +1,374 @@
+#include "JobSystem.hpp"
+#include "kengine.hpp"
+
+// stl
+#include <algorithm>
+#include <atomic>
+#include <bit>
+#include <cstring>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <variant>
+#include <vector>
+
+#ifdef _WIN32
+# include <windows.h>
+#else
+# include <sched.h>
+#endif
+
+// kengine data
+#include "data/LuaStateComponent.hpp"
+
+// kengine helpers
+#include "helpers/commandLineHelper.hpp"
+#include "helpers/logHelper.hpp"
+
+// api
+#include "JobsComponent.hpp"
+
+// project
+#include "ThreadPlacementSystem.hpp"
+#include "helpers/WorkStealingPool.hpp"
+
+namespace {
+    struct Options {
+        size_t jobThreads = 0;
+    };
+}
+
+#define refltype Options
+putils_reflection_info{
+    putils_reflection_custom_class_name(Jobs);
+    putils_reflection_attributes(
+        putils_reflection_attribute(jobThreads,
+            putils_reflection_metadata("help", "Number of threads running jobs and systems besides the main thread (defaults to the number of cores set by jobCores, or one less than the number of cores the overlay may run on)")
+        )
+    );
+};
+#undef refltype
+
+namespace koverlay {
+    struct Job {
+        Jobs::Function function;
+        void * data;
+
+        // Held by the creator, by the pool while queued or running, and by previous jobs that haven't finished
+        std::atomic<int> references = 1;
+        // 1 until submitted, plus 1 per previous job that hasn't finished
+        std::atomic<int> blockers = 1;
+        // Set by whichever of the pool and a waiting thread runs it first
+        std::atomic<bool> claimed = false;
+
+        std::mutex mutex;
+        std::atomic<bool> done = false;
+        std::vector<Job *> next;
+    };
+}
+
+namespace {
+    struct impl {
+        static inline std::unique_ptr<WorkStealingPool> pool;
+        static inline koverlay::Jobs jobs;
+
+        static void init(kengine::Entity &system) noexcept {
+            const auto options = kengine::parseCommandLine<Options>();
+            const auto threads = getThreadCount(options);
+            pool = std::make_unique<WorkStealingPool>(threads);
+
+            jobs = koverlay::Jobs{
+                .create = create,
+                .then = then,
+                .submit = unblock,
+                .wait = wait,
+                .finished = [](const koverlay::Job *job) noexcept -> bool { return job->done; },
+                .release = release,
+                .workerCount = threads
+            };
+            system += koverlay::JobsComponent{ &jobs };
+
+            for (const auto &[e, state]: kengine::entities.with<kengine::LuaStateComponent>())
+                registerBindings(*state.state);
+        }
+
+        static size_t getThreadCount(const Options &options) noexcept {
+            if (options.jobThreads != 0)
+                return options.jobThreads;
+            // One per core jobs may run on, as the render thread is expected to run on others
+            if (const auto jobCores = getJobCoreCount())
+                return jobCores;
+            return std::max<size_t>(getAvailableCores(), 2) - 1;
+        }
+
+        // Cores in the process' affinity mask, which may be restricted by the user or a container
+        static size_t getAvailableCores() noexcept {
+#ifdef _WIN32
+            DWORD_PTR processMask, systemMask;
+            if (GetProcessAffinityMask(GetCurrentProcess(), &processMask, &systemMask))
+                return (size_t)std::popcount((unsigned long long)processMask);
+#else
+            cpu_set_t set;
+            if (sched_getaffinity(0, sizeof(set), &set) == 0)
+                return (size_t)CPU_COUNT(&set);
+#endif
+            return std::thread::hardware_concurrency();
+        }
+
+        static koverlay::Job *create(koverlay::Jobs::Function function, void *data) noexcept {
+            return new koverlay::Job{ .function = function, .data = data };
+        }
+
+        static void then(koverlay::Job *previous, koverlay::Job *next) noexcept {
+            const std::lock_guard lock(previous->mutex);
+            if (previous->done)
+                return;
+            ++next->blockers;
+            ++next->references;
+            previous->next.push_back(next);
+        }
+
+        static void unblock(koverlay::Job *job) noexcept {
+            if (--job->blockers != 0)
+                return;
+            ++job->references;
+            pool->push([job] { run(job); }, WorkStealingPool::Kind::Job);
+        }
+
+        static void run(koverlay::Job *job) noexcept {
+            if (!job->claimed.exchange(true))
+                execute(job);
+            release(job);
+        }
+
+        static void execute(koverlay::Job *job) noexcept {
+            job->function(job->data);
+
+            std::vector<koverlay::Job *> next;
+            {
+                const std::lock_guard lock(job->mutex);
+                job->done = true;
+                next.swap(job->next);
+            }
+            job->done.notify_all();
+            for (const auto n: next) {
+                unblock(n);
+                release(n);
+            }
+        }
+
+        static void wait(koverlay::Job *job) noexcept {
+            // Workers run other jobs meanwhile, as all of them may end up waiting. Other threads (e.g. the render thread) only run the
+            // job they wait for, if it's ready and no worker has started it, as other jobs may take much longer
+            if (!pool->isWorkerThread()) {
+                if (job->blockers == 0 && !job->claimed.exchange(true))
+                    execute(job);
+                job->done.wait(false);
+                return;
+            }
+
+            while (!job->done)
+                if (!pool->runOne())
+                    std::this_thread::yield();
+        }
+
+        static void release(koverlay::Job *job) noexcept {
+            if (--job->references == 0)
+                delete job;
+        }
+
+        // Lua values made only of data, copied between the overlay's Lua state and the workers' ones
+        struct LuaData;
+        struct LuaTable {
+            std::vector<LuaData> keys;
+            std::vector<LuaData> values;
+        };
+        struct LuaData {
+            std::variant<std::monostate, bool, double, std::string, LuaTable> value;
+        };
+
+        struct LuaJob {
+            std::string bytecode;
+            std::vector<LuaData> arguments;
+            std::vector<LuaData> results;
+            std::string error;
+            // Set by whichever of the pool and a waiting thread runs it first
+            std::atomic<bool> claimed = false;
+            std::atomic<bool> done = false;
+        };
+
+        struct LuaJobHandle {
+            std::shared_ptr<LuaJob> job;
+        };
+
+        static void registerBindings(sol::state &state) noexcept {
+            state.new_usertype<LuaJobHandle>("KoverlayJob", sol::no_constructor,
+                "done", sol::property([](const LuaJobHandle &handle) -> bool { return handle.job->done; }),
+                // Runs the job on the calling thread if no worker has started it yet, but never other jobs, which may take much longer
+                "wait", [](const LuaJobHandle &handle) {
+                    auto &job = *handle.job;
+                    if (!job.claimed.exchange(true))
+                        runLuaJob(job);
+                    job.done.wait(false);
+                },
+                // Returns the function's results, or nil and an error message if it failed. Nothing until the job is done
+                "result", [](const LuaJobHandle &handle, sol::this_state s) {
+                    sol::variadic_results results;
+                    const auto &job = *handle.job;
+                    if (!job.done)
+                        return results;
+                    if (!job.error.empty()) {
+                        results.push_back(sol::make_object(s, sol::lua_nil));
+                        results.push_back(sol::make_object(s, job.error));
+                        return results;
+                    }
+                    for (const auto &data: job.results)
+                        results.push_back(toLua(s, data));
+                    return results;
+                }
+            );
+
+            auto table = state.create_named_table("jobs");
+            table["run"] = [](sol::this_state s, sol::function function, sol::variadic_args args) -> sol::object {
+                auto job = std::make_shared<LuaJob>();
+                if (!dump(function, job->bytecode))
+                    return sol::make_object(s, sol::lua_nil);
+
+                for (const auto &arg: args) {
+                    auto &data = job->arguments.emplace_back();
+                    if (!toData(arg, data, 0)) {
+                        kengine_log(Error, "Jobs", "jobs.run arguments may only be nil, booleans, numbers, strings and tables of those");
+                        return sol::make_object(s, sol::lua_nil);
+                    }
+                }
+
+                pool->push([job] {
+                    if (!job->claimed.exchange(true))
+                        runLuaJob(*job);
+                }, WorkStealingPool::Kind::Job);
+                return sol::make_object(s, LuaJobHandle{ std::move(job) });
+            };
+        }
+
+        // Functions are copied to workers as bytecode, so they can't use upvalues (i.e. local variables from enclosing scopes)
+        static bool dump(const sol::function &function, std::string &bytecode) noexcept {
+            const auto L = function.lua_state();
+            function.push();
+            bool valid = !lua_iscfunction(L, -1);
+            for (int i = 1; valid; ++i) {
+                const auto name = lua_getupvalue(L, -1, i);
+                if (name == nullptr)
+                    break;
+                lua_pop(L, 1);
+                valid = std::strcmp(name, "_ENV") == 0;
+            }
+            lua_pop(L, 1);
+
+            if (!valid) {
+                kengine_log(Error, "Jobs", "jobs.run functions must be Lua functions that don't use local variables from enclosing scopes");
+                return false;
+            }
+
+            const sol::state_view lua(L);
+            const sol::protected_function stringDump = lua["string"]["dump"];
+            const sol::protected_function_result result = stringDump(function);
+            if (!result.valid())
+                return false;
+            bytecode = result.get<std::string>();
+            return true;
+        }
+
+        static void runLuaJob(LuaJob &job) noexcept {
+            // Each thread has its own state, with only the libraries that don't have side effects
+            thread_local std::unique_ptr<sol::state> state;
+            if (!state) {
+                state = std::make_unique<sol::state>();
+                state->open_libraries(sol::lib::base, sol::lib::math, sol::lib::string, sol::lib::table, sol::lib::utf8);
+            }
+
+            const auto fail = [&](std::string error) noexcept {
+                job.error = std::move(error);
+                job.done = true;
+                job.done.notify_all();
+            };
+
+            const sol::load_result loaded = state->load(job.bytecode, "job", sol::load_mode::binary);
+            if (!loaded.valid())
+                return fail(loaded.get<sol::error>().what());
+
+            std::vector<sol::object> arguments;
+            for (const auto &data: job.arguments)
+                arguments.push_back(toLua(*state, data));
+
+            const sol::protected_function function = loaded;
+            const sol::protected_function_result result = function(sol::as_args(arguments));
+            if (!result.valid())
+                return fail(result.get<sol::error>().what());
+
+            for (const auto &value: result) {
+                auto &data = job.results.emplace_back();
+                if (!toData(value, data, 0))
+                    return fail("jobs.run functions may only return nil, booleans, numbers, strings and tables of those");
+            }
+            job.done = true;
+            job.done.notify_all();
+        }
+
+        static bool toData(const sol::object &object, LuaData &data, int depth) noexcept {
+            // Deeper tables are most likely cyclic
+            static constexpr int maxDepth = 32;
+
+            switch (object.get_type()) {
+                case sol::type::lua_nil:
+                case sol::type::none:
+                    data.value = std::monostate{};
+                    return true;
+                case sol::type::boolean:
+                    data.value = object.as<bool>();
+                    return true;
+                case sol::type::number:
+                    data.value = object.as<double>();
+                    return true;
+                case sol::type::string:
+                    data.value = object.as<std::string>();
+                    return true;
+                case sol::type::table: {
+                    if (depth >= maxDepth)
+                        return false;
+                    auto &table = data.value.emplace<LuaTable>();
+                    for (const auto &[key, value]: object.as<sol::table>()) {
+                        if (!toData(key, table.keys.emplace_back(), depth + 1) || !toData(value, table.values.emplace_back(), depth + 1))
+                            return false;
+                    }
+                    return true;
+                }
+                default:
+                    return false;
+            }
+        }
+
+        static sol::object toLua(sol::state_view lua, const LuaData &data) noexcept {
+            return std::visit([&]<typename T>(const T &value) -> sol::object {
+                if constexpr (std::is_same_v<T, std::monostate>)
+                    return sol::make_object(lua, sol::lua_nil);
+                else if constexpr (std::is_same_v<T, LuaTable>) {
+                    auto table = lua.create_table(0, (int)value.keys.size());
+                    for (size_t i = 0; i < value.keys.size(); ++i)
+                        table[toLua(lua, value.keys[i])] = toLua(lua, value.values[i]);
+                    return table;
+                }
+                else
+                    return sol::make_object(lua, value);
+            }, data.value);
+        }
+    };
+}
+
+kengine::EntityCreator * JobSystem() noexcept {
+	return impl::init;
+}
+
+WorkStealingPool & getJobPool() noexcept {
+    return *impl::pool;
+}
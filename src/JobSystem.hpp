@@ -0,0 +1,11 @@
+#pragma once
+
+#include "EntityCreator.hpp"
+
+class WorkStealingPool;
+
+// Runs the job system shared by the overlay, plugins (through a JobsComponent) and Lua scripts (through `jobs.run`)
+kengine::EntityCreator * JobSystem() noexcept;
+
+// Threads running jobs, also used to run systems in parallel
+WorkStealingPool & getJobPool() noexcept;
@@ -0,0 +1,280 @@
+#include "LuaBufferSystem.hpp"
+#include "kengine.hpp"
+
+// stl
+#include <algorithm>
+#include <cfloat>
+#include <fstream>
+#include <memory>
+#include <optional>
+#include <string>
+#include <vector>
+
+// kengine data
+#include "data/LuaStateComponent.hpp"
+
+// kengine helpers
+#include "helpers/logHelper.hpp"
+
+// imgui
+#include "imgui.h"
+
+// project
+#include "FeedSystem.hpp"
+
+namespace {
+    struct impl {
+        enum class Type {
+            Float,
+            Double,
+            Int,
+        };
+
+        // Typed array of numbers, stored in memory owned by the buffer, or in a ring feed
+        // Lua indices are 1-based, and start at `offset` for buffers filled with `push`
+        struct Buffer {
+            Type type = Type::Float;
+            size_t count = 0;
+            // Next element overwritten by `push`, and first element plotted
+            size_t offset = 0;
+
+            // nullptr for feed views, read-only for file contents
+            const char * data = nullptr;
+            bool writable = false;
+            std::shared_ptr<void> storage;
+
+            std::shared_ptr<koverlay::Feed> feed;
+            int field = 1;
+
+            size_t size() const noexcept {
+                if (!feed)
+                    return count;
+                return getFeedSize(feed->getHead());
+            }
+
+            size_t getFeedSize(uint64_t head) const noexcept {
+                return (size_t)std::min<uint64_t>(head, feed->getHeader().capacity);
+            }
+
+            // `i` is relative to `offset` (or to the oldest element still in a feed), and 0-based
+            double get(size_t i) const noexcept {
+                if (feed) {
+                    // Elements overwritten since `size()` was called read as 0
+                    const auto head = feed->getHead();
+                    return readFeedField(*feed, head - getFeedSize(head) + i, field).value_or(0.0);
+                }
+
+                const auto index = (offset + i) % count;
+                switch (type) {
+                    case Type::Float:
+                        return ((const float *)data)[index];
+                    case Type::Double:
+                        return ((const double *)data)[index];
+                    default:
+                        return ((const int32_t *)data)[index];
+                }
+            }
+
+            void set(size_t i, double value) noexcept {
+                const auto index = (offset + i) % count;
+                const auto writableData = const_cast<char *>(data);
+                switch (type) {
+                    case Type::Float:
+                        ((float *)writableData)[index] = (float)value;
+                        break;
+                    case Type::Double:
+                        ((double *)writableData)[index] = value;
+                        break;
+                    default:
+                        ((int32_t *)writableData)[index] = (int32_t)value;
+                        break;
+                }
+            }
+        };
+
+        static void init(kengine::Entity &) noexcept {
+            for (const auto &[e, state]: kengine::entities.with<kengine::LuaStateComponent>())
+                registerBindings(*state.state);
+        }
+
+        static void registerBindings(sol::state &state) noexcept {
+            state.new_usertype<Buffer>("KoverlayBuffer", sol::no_constructor,
+                "type", sol::property([](const Buffer &buffer) { return getTypeName(buffer.type); }),
+                "writable", sol::readonly(&Buffer::writable),
+                "push", [](Buffer &buffer, double value) {
+                    if (!checkWritable(buffer))
+                        return;
+                    buffer.set(0, value);
+                    buffer.offset = (buffer.offset + 1) % buffer.count;
+                },
+                "fill", [](Buffer &buffer, double value) {
+                    if (!checkWritable(buffer))
+                        return;
+                    for (size_t i = 0; i < buffer.count; ++i)
+                        buffer.set(i, value);
+                },
+                // Fallbacks for keys that aren't one of the above
+                sol::meta_function::index, [](const Buffer &buffer, size_t i) -> sol::optional<double> {
+                    if (i < 1 || i > buffer.size())
+                        return sol::nullopt;
+                    return buffer.get(i - 1);
+                },
+                sol::meta_function::new_index, [](Buffer &buffer, size_t i, double value) {
+                    if (!checkWritable(buffer))
+                        return;
+                    if (i < 1 || i > buffer.count) {
+                        kengine_logf(Error, "Lua", "Buffer index %zu out of range [1, %zu]", i, buffer.count);
+                        return;
+                    }
+                    buffer.set(i - 1, value);
+                },
+                sol::meta_function::length, &Buffer::size
+            );
+
+            auto table = state.create_named_table("buffers");
+            table["new"] = [](const std::string &typeName, size_t count) -> sol::optional<Buffer> {
+                const auto type = parseType(typeName);
+                if (!type || count == 0)
+                    return sol::nullopt;
+
+                const auto storage = std::make_shared<std::vector<double>>((count * getTypeSize(*type) + sizeof(double) - 1) / sizeof(double));
+                return Buffer{
+                    .type = *type,
+                    .count = count,
+                    .data = (const char *)storage->data(),
+                    .writable = true,
+                    .storage = storage
+                };
+            };
+            table["map"] = [](const std::string &path, const std::string &typeName) -> sol::optional<Buffer> {
+                const auto type = parseType(typeName);
+                if (!type)
+                    return sol::nullopt;
+
+                // Copied rather than mapped, as reading a mapped file that's since been truncated would crash the overlay
+                std::ifstream file(path, std::ios::binary | std::ios::ate);
+                const auto fileSize = file ? (size_t)file.tellg() : 0;
+                const auto count = fileSize / getTypeSize(*type);
+                if (count == 0)
+                    return sol::nullopt;
+
+                const auto storage = std::make_shared<std::vector<double>>((count * getTypeSize(*type) + sizeof(double) - 1) / sizeof(double));
+                file.seekg(0);
+                if (!file.read((char *)storage->data(), std::streamsize(count * getTypeSize(*type))))
+                    return sol::nullopt;
+                return Buffer{
+                    .type = *type,
+                    .count = count,
+                    .data = (const char *)storage->data(),
+                    .storage = storage
+                };
+            };
+            table["feed"] = [](const std::string &name, sol::optional<int> field) -> sol::optional<Buffer> {
+                auto feed = openFeed(name);
+                if (!feed || feed->getHeader().kind != KOVERLAY_FEED_RING)
+                    return sol::nullopt;
+                return Buffer{
+                    .type = Type::Double,
+                    .feed = std::move(feed),
+                    .field = field.value_or(1)
+                };
+            };
+
+            sol::optional<sol::table> imgui = state["imgui"];
+            if (!imgui) {
+                kengine_log(Error, "Lua", "ImGui bindings must be loaded before LuaBufferSystem");
+                return;
+            }
+            wrapPlotFunction(*imgui, "PlotLines", [](const char *label, const float *values, int count, int offset, const char *overlay, float min, float max, ImVec2 size) {
+                ImGui::PlotLines(label, values, count, offset, overlay, min, max, size);
+            });
+            wrapPlotFunction(*imgui, "PlotHistogram", [](const char *label, const float *values, int count, int offset, const char *overlay, float min, float max, ImVec2 size) {
+                ImGui::PlotHistogram(label, values, count, offset, overlay, min, max, size);
+            });
+        }
+
+        // Replaces `imgui[name]` with a function that draws buffers directly, and forwards any other call to the original binding
+        // Buffers are plotted with `imgui.PlotLines(label, buffer, [overlayText], [scaleMin], [scaleMax], [graphWidth], [graphHeight])`
+        template<typename Plot>
+        static void wrapPlotFunction(sol::table &imgui, const char *name, Plot plot) noexcept {
+            const sol::protected_function original = imgui[name];
+            imgui[name] = [original, plot](sol::variadic_args args) -> sol::variadic_results {
+                if (args.size() < 2 || !args[1].is<Buffer>()) {
+                    sol::variadic_results results;
+                    if (!original.valid())
+                        return results;
+                    const sol::protected_function_result result = original(args);
+                    if (!result.valid()) // raised again in the calling script, as a protected call returns the error instead
+                        throw result.get<sol::error>();
+                    results.assign(result.begin(), result.end());
+                    return results;
+                }
+
+                const auto label = args[0].get<std::string>();
+                const auto &buffer = args[1].get<Buffer>();
+                const auto overlay = args.size() > 2 ? args[2].get<sol::optional<std::string>>() : sol::nullopt;
+                const auto getFloat = [&](size_t i, float defaultValue) noexcept {
+                    return args.size() > i ? args[i].get<sol::optional<float>>().value_or(defaultValue) : defaultValue;
+                };
+                const auto min = getFloat(3, FLT_MAX);
+                const auto max = getFloat(4, FLT_MAX);
+                const ImVec2 size{ getFloat(5, 0.f), getFloat(6, 0.f) };
+
+                const auto count = (int)buffer.size();
+                const auto overlayText = overlay ? overlay->c_str() : nullptr;
+                if (buffer.type == Type::Float && buffer.data != nullptr)
+                    plot(label.c_str(), (const float *)buffer.data, count, (int)buffer.offset, overlayText, min, max, size);
+                else {
+                    // Other types are converted into a reused array, which still costs a lot less than building a table
+                    static std::vector<float> converted;
+                    converted.resize(count);
+                    for (int i = 0; i < count; ++i)
+                        converted[i] = (float)buffer.get(i);
+                    plot(label.c_str(), converted.data(), count, 0, overlayText, min, max, size);
+                }
+                return {};
+            };
+        }
+
+        static bool checkWritable(const Buffer &buffer) noexcept {
+            if (!buffer.writable)
+                kengine_log(Error, "Lua", "Attempt to write to a read-only buffer");
+            return buffer.writable;
+        }
+
+        static std::optional<Type> parseType(const std::string &name) noexcept {
+            if (name == "float")
+                return Type::Float;
+            if (name == "double")
+                return Type::Double;
+            if (name == "int")
+                return Type::Int;
+            kengine_logf(Error, "Lua", "Unknown buffer type '%s', expected 'float', 'double' or 'int'", name.c_str());
+            return std::nullopt;
+        }
+
+        static const char *getTypeName(Type type) noexcept {
+            switch (type) {
+                case Type::Float:
+                    return "float";
+                case Type::Double:
+                    return "double";
+                default:
+                    return "int";
+            }
+        }
+
+        static size_t getTypeSize(Type type) noexcept {
+            switch (type) {
+                case Type::Double:
+                    return sizeof(double);
+                default:
+                    return 4;
+            }
+        }
+    };
+}
+
+kengine::EntityCreator * LuaBufferSystem() noexcept {
+	return impl::init;
+}
@@ -0,0 +1,7 @@
+#pragma once
+
+#include "EntityCreator.hpp"
+
+// Exposes typed numeric buffers to Lua scripts, through the `buffers` table, and lets `imgui.PlotLines` and `imgui.PlotHistogram` draw them without building Lua tables
+// Must be added after ImGuiLuaSystem, whose plot functions it wraps
+kengine::EntityCreator * LuaBufferSystem() noexcept;
@@ -0,0 +1,177 @@
+#include "LuaGCSystem.hpp"
+#include "kengine.hpp"
+
+// stl
+#include <algorithm>
+#include <array>
+#include <chrono>
+#include <string>
+
+// kengine data
+#include "data/LuaStateComponent.hpp"
+
+// kengine helpers
+#include "helpers/commandLineHelper.hpp"
+#include "helpers/logHelper.hpp"
+
+// imgui
+#include "imgui.h"
+
+// api
+#include "FrameEndComponent.hpp"
+#include "ProfilerSectionComponent.hpp"
+
+namespace {
+    struct Options {
+        std::string luaGCMode = "incremental";
+        bool luaGCInFrameSlack = true;
+    };
+}
+
+#define refltype Options
+putils_reflection_info{
+    putils_reflection_custom_class_name(Lua GC);
+    putils_reflection_attributes(
+        putils_reflection_attribute(luaGCMode,
+            putils_reflection_metadata("help", "Lua garbage collector mode: \"incremental\" or \"generational\" (Lua 5.4 only)")
+        ),
+        putils_reflection_attribute(luaGCInFrameSlack,
+            putils_reflection_metadata("help", "Collect Lua garbage between frames, within a time budget, instead of during allocations")
+        )
+    );
+};
+#undef refltype
+
+namespace {
+    struct impl {
+        // Budget of each frame's incremental steps, in milliseconds
+        static constexpr float minBudget = .25f;
+        static constexpr float maxBudget = 4.f;
+        static constexpr float budgetGrowth = .05f;
+        // A frame this much longer than average probably missed vsync
+        static constexpr float lateFrameRatio = 1.25f;
+        static constexpr float averageWeight = .05f;
+        // Work done by each incremental step, see LUA_GCSTEP
+        static constexpr int stepSize = 64;
+        // Generational mode runs a minor collection once memory has grown by this much, like Lua's default minor multiplier
+        static constexpr float minorGrowth = 1.2f;
+        // Past these multiples of the memory left by the last cycle, the budget is raised to its maximum, then a full collection is forced
+        static constexpr float urgentGrowth = 2.f;
+        static constexpr float fullCollectionGrowth = 4.f;
+
+        static inline lua_State *L = nullptr;
+        static inline bool generational = false;
+        static inline bool stopped = false;
+
+        static inline float budget = 1.f;
+        static inline float averageFrameTime = 0.f;
+        // In KB
+        static inline float memoryAfterCycle = 0.f;
+        static inline float memoryAfterStep = 0.f;
+
+        static inline float lastTime = 0.f;
+        static inline float peakTime = 0.f;
+        static inline std::array<float, 120> history{};
+        static inline size_t historyOffset = 0;
+
+        static void init(kengine::Entity &system) noexcept {
+            const auto options = kengine::parseCommandLine<Options>();
+
+            for (const auto &[e, state]: kengine::entities.with<kengine::LuaStateComponent>()) {
+                L = state.state->lua_state();
+                break;
+            }
+            if (L == nullptr)
+                return;
+
+            if (options.luaGCMode == "generational") {
+#if LUA_VERSION_NUM >= 504
+                lua_gc(L, LUA_GCGEN, 0, 0);
+                generational = true;
+#else
+                kengine_logf(Warning, "Lua GC", "Generational mode requires Lua 5.4, using incremental mode with Lua %d", LUA_VERSION_NUM);
+#endif
+            }
+            else if (options.luaGCMode != "incremental")
+                kengine_logf(Error, "Lua GC", "Unknown mode '%s', expected 'incremental' or 'generational'", options.luaGCMode.c_str());
+
+            memoryAfterCycle = memoryAfterStep = getMemory();
+
+            if (options.luaGCInFrameSlack)
+                system += koverlay::FrameEndComponent{ collect };
+            system += koverlay::ProfilerSectionComponent{ "Lua GC", draw };
+        }
+
+        static float getMemory() noexcept {
+            return (float)lua_gc(L, LUA_GCCOUNT, 0) + (float)lua_gc(L, LUA_GCCOUNTB, 0) / 1024.f;
+        }
+
+        static void collect(float frameTime) noexcept {
+            // Only stopped once called, so that collection stays automatic if the scheduler never calls FrameEndComponents
+            if (!stopped) {
+                lua_gc(L, LUA_GCSTOP, 0);
+                stopped = true;
+                averageFrameTime = frameTime;
+            }
+
+            adjustBudget(frameTime);
+
+            const auto start = std::chrono::steady_clock::now();
+            const auto memory = getMemory();
+            if (memory > memoryAfterCycle * fullCollectionGrowth) {
+                // Steps haven't kept up with allocations: a full collection takes longer, but avoids running out of memory
+                lua_gc(L, LUA_GCCOLLECT, 0);
+                memoryAfterCycle = memoryAfterStep = getMemory();
+            }
+            else if (generational) {
+                // Minor collections can't be split into steps
+                if (memory > memoryAfterStep * minorGrowth) {
+                    lua_gc(L, LUA_GCSTEP, 0);
+                    memoryAfterCycle = memoryAfterStep = getMemory();
+                }
+            }
+            else {
+                if (memory > memoryAfterCycle * urgentGrowth)
+                    budget = maxBudget;
+                const auto deadline = start + std::chrono::duration<float, std::milli>(budget);
+                do {
+                    // Returns 1 once a cycle is complete
+                    if (lua_gc(L, LUA_GCSTEP, stepSize)) {
+                        memoryAfterCycle = getMemory();
+                        break;
+                    }
+                } while (std::chrono::steady_clock::now() < deadline);
+            }
+
+            lastTime = std::chrono::duration<float, std::milli>(std::chrono::steady_clock::now() - start).count();
+            peakTime = std::max(peakTime, lastTime);
+            history[historyOffset] = lastTime;
+            historyOffset = (historyOffset + 1) % history.size();
+        }
+
+        static void adjustBudget(float frameTime) noexcept {
+            if (frameTime > averageFrameTime * lateFrameRatio)
+                budget /= 2.f;
+            else
+                budget += budgetGrowth;
+            budget = std::clamp(budget, minBudget, maxBudget);
+            averageFrameTime += (frameTime - averageFrameTime) * averageWeight;
+        }
+
+        static void draw() noexcept {
+            ImGui::Text("Mode: %s%s", generational ? "generational" : "incremental", stopped ? ", between frames" : ", automatic");
+            ImGui::Text("Memory: %.0f KB (%.0f KB after last cycle)", getMemory(), memoryAfterCycle);
+            if (!stopped)
+                return;
+
+            ImGui::Text("GC: %.3f ms (peak %.3f ms), budget %.2f ms", lastTime, peakTime, budget);
+            if (ImGui::Button("Reset peak"))
+                peakTime = 0.f;
+            ImGui::PlotLines("##Lua GC", history.data(), (int)history.size(), (int)historyOffset, nullptr, 0.f, maxBudget, { 0.f, 60.f });
+        }
+    };
+}
+
+kengine::EntityCreator * LuaGCSystem() noexcept {
+    return impl::init;
+}
@@ -0,0 +1,8 @@
+#pragma once
+
+#include "EntityCreator.hpp"
+
+// Stops Lua's automatic garbage collection and instead runs it once each frame has been submitted, within a time budget that
+// shrinks when frames are late. Optionally switches the state to generational mode (Lua 5.4)
+// Relies on the overlay's scheduler calling FrameEndComponents: when `parallelSystems` is disabled, collection stays automatic
+kengine::EntityCreator * LuaGCSystem() noexcept;
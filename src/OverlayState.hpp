@@ -0,0 +1,9 @@
+#pragma once
+
+// Whether tools are currently shown. Toggled by Alt+Q and by double-clicking the system tray icon
+inline bool g_overlayEnabled = true;
+
+// Attached to tools while the overlay is hidden, to restore their state once it is shown again
+struct ToolSave {
+    bool enabled = false;
+};
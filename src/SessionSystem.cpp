@@ -0,0 +1,233 @@
+#include "SessionSystem.hpp"
+#include "kengine.hpp"
+
+// stl
+#include <cstdint>
+#include <optional>
+#include <unordered_map>
+#include <vector>
+
+// kengine data
+#include "data/ImGuiToolComponent.hpp"
+#include "data/NameComponent.hpp"
+
+// kengine functions
+#include "functions/Execute.hpp"
+
+// kengine helpers
+#include "helpers/commandLineHelper.hpp"
+#include "helpers/logHelper.hpp"
+
+// api
+#include "ComponentEventsComponent.hpp"
+
+// project
+#include "OverlayState.hpp"
+#include "helpers/BackgroundFileWriter.hpp"
+#include "helpers/MappedFile.hpp"
+#include "helpers/binarySnapshotHelper.hpp"
+
+#include "imgui.h"
+
+namespace {
+    struct Options {
+        std::string sessionFile = "session.bin";
+        float sessionSaveInterval = 30.f;
+    };
+
+    // Strings are views: into live components when saving, into the mapped file when restoring
+    struct ToolRecord {
+        std::string_view name;
+        bool enabled = false;
+        std::optional<bool> saved;
+    };
+
+    // Adjustables aren't part of it, as they're persisted in adjust.cnf by AdjustableStoreSystem
+    struct Snapshot {
+        bool overlayEnabled = true;
+        std::vector<ToolRecord> tools;
+        std::string_view imguiIni;
+    };
+}
+
+#define refltype Options
+putils_reflection_info{
+    putils_reflection_custom_class_name(Session);
+    putils_reflection_attributes(
+        putils_reflection_attribute(sessionFile,
+            putils_reflection_metadata("help", "File the overlay's state is saved to and restored from")
+        ),
+        putils_reflection_attribute(sessionSaveInterval,
+            putils_reflection_metadata("help", "Seconds between background session saves")
+        )
+    );
+};
+#undef refltype
+
+#define refltype ToolRecord
+putils_reflection_info{
+    putils_reflection_attributes(
+        putils_reflection_attribute(name),
+        putils_reflection_attribute(enabled),
+        putils_reflection_attribute(saved)
+    );
+};
+#undef refltype
+
+#define refltype Snapshot
+putils_reflection_info{
+    putils_reflection_attributes(
+        putils_reflection_attribute(overlayEnabled),
+        putils_reflection_attribute(tools),
+        putils_reflection_attribute(imguiIni)
+    );
+};
+#undef refltype
+
+namespace {
+    struct impl {
+        static constexpr std::uint32_t magic = 0x53564f4b; // "KOVS"
+        static constexpr std::uint32_t version = 1;
+
+        // Time given to plugins and scripts to create the tools found in the snapshot
+        static constexpr float restoreTimeout = 10.f;
+
+        static inline Options options;
+        static inline float timeSinceSave = 0.f;
+
+        static inline struct {
+            MappedFile file;
+            Snapshot snapshot;
+            bool imguiRestored = false;
+            float elapsed = 0.f;
+            std::unordered_map<std::string_view, const ToolRecord *> tools;
+        } restore;
+
+        static void init(kengine::Entity & system) noexcept {
+            options = kengine::parseCommandLine<Options>();
+            load();
+            system += kengine::functions::Execute{ execute };
+        }
+
+        static void execute(float deltaTime) noexcept {
+            if (restore.file)
+                applyRestore(deltaTime);
+
+            timeSinceSave += deltaTime;
+            if (timeSinceSave < options.sessionSaveInterval)
+                return;
+            timeSinceSave = 0.f;
+            backgroundFileWriter().write(options.sessionFile, serialize());
+        }
+
+        //
+        // Saving
+        //
+
+        // Runs on the main thread, as it reads live components. Only the file I/O is deferred
+        static std::string serialize() noexcept {
+            Snapshot snapshot;
+            snapshot.overlayEnabled = g_overlayEnabled;
+
+            for (const auto & [e, name, tool] : kengine::entities.with<kengine::NameComponent, kengine::ImGuiToolComponent>()) {
+                auto & record = snapshot.tools.emplace_back();
+                record.name = name.name.c_str();
+                record.enabled = tool.enabled;
+                if (const auto save = e.tryGet<ToolSave>())
+                    record.saved = save->enabled;
+            }
+
+            if (ImGui::GetCurrentContext()) {
+                size_t size = 0;
+                const auto ini = ImGui::SaveIniSettingsToMemory(&size);
+                snapshot.imguiIni = std::string_view(ini, size);
+            }
+
+            std::string ret;
+            binarySnapshotHelper::write(ret, magic);
+            binarySnapshotHelper::write(ret, version);
+            binarySnapshotHelper::write(ret, snapshot);
+            return ret;
+        }
+
+        static void save() noexcept {
+            backgroundFileWriter().flush();
+            backgroundFileWriter().logErrors();
+            restore.file = MappedFile{}; // Windows won't replace a mapped file
+            writeFileAtomically(options.sessionFile, serialize());
+        }
+
+        //
+        // Restoring
+        //
+
+        static void load() noexcept {
+            restore.file = MappedFile(options.sessionFile.c_str());
+            if (!restore.file)
+                return;
+
+            const auto data = restore.file.view();
+            std::uint32_t fileMagic = 0;
+            std::uint32_t fileVersion = 0;
+            if (!binarySnapshotHelper::read(data.substr(0, 4), fileMagic) || fileMagic != magic ||
+                !binarySnapshotHelper::read(data.substr(4, 4), fileVersion) || fileVersion != version ||
+                !binarySnapshotHelper::read(data.substr(8), restore.snapshot)) {
+                kengine_logf(Warning, "Session", "Ignoring invalid session file %s", options.sessionFile.c_str());
+                restore.file = MappedFile{};
+                return;
+            }
+
+            kengine_logf(Log, "Session", "Restoring session from %s", options.sessionFile.c_str());
+            g_overlayEnabled = restore.snapshot.overlayEnabled;
+            for (const auto & record : restore.snapshot.tools)
+                restore.tools[record.name] = &record;
+        }
+
+        static void applyRestore(float deltaTime) noexcept {
+            if (!restore.imguiRestored && ImGui::GetCurrentContext()) {
+                const auto & ini = restore.snapshot.imguiIni;
+                if (!ini.empty())
+                    ImGui::LoadIniSettingsFromMemory(ini.data(), ini.size());
+                restore.imguiRestored = true;
+            }
+
+            if (!restore.tools.empty()) {
+                static std::vector<kengine::EntityID> modified;
+                modified.clear();
+                for (const auto & [e, name, tool] : kengine::entities.with<kengine::NameComponent, kengine::ImGuiToolComponent>()) {
+                    const auto it = restore.tools.find(name.name.c_str());
+                    if (it == restore.tools.end())
+                        continue;
+                    const auto & record = *it->second;
+                    if (tool.enabled != record.enabled) {
+                        tool.enabled = record.enabled;
+                        modified.push_back(e.id);
+                    }
+                    if (record.saved)
+                        e += ToolSave{ *record.saved };
+                    restore.tools.erase(it);
+                }
+
+                for (const auto id : modified) {
+                    auto e = kengine::entities[id];
+                    koverlay::componentEvents::notifyModified<kengine::ImGuiToolComponent>(e);
+                }
+            }
+
+            restore.elapsed += deltaTime;
+            if ((restore.imguiRestored && restore.tools.empty()) || restore.elapsed > restoreTimeout) {
+                restore.tools.clear();
+                restore.snapshot = {};
+                restore.file = MappedFile{};
+            }
+        }
+    };
+}
+
+kengine::EntityCreator * SessionSystem() noexcept {
+    return impl::init;
+}
+
+void saveSession() noexcept {
+    impl::save();
+}
@@ -0,0 +1,8 @@
+#pragma once
+
+#include "EntityCreator.hpp"
+
+kengine::EntityCreator * SessionSystem() noexcept;
+
+// Synchronously writes the session snapshot, waiting for any background write to finish first
+void saveSession() noexcept;
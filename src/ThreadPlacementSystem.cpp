@@ -0,0 +1,255 @@
+#include "ThreadPlacementSystem.hpp"
+#include "kengine.hpp"
+
+// stl
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <bit>
+#include <mutex>
+#include <optional>
+#include <string>
+#include <thread>
+#include <vector>
+
+// kengine data
+#include "data/AdjustableComponent.hpp"
+
+// kengine functions
+#include "functions/Execute.hpp"
+
+// kengine helpers
+#include "helpers/commandLineHelper.hpp"
+#include "helpers/logHelper.hpp"
+
+// imgui
+#include "imgui.h"
+
+// api
+#include "ProfilerSectionComponent.hpp"
+#include "SystemAccessComponent.hpp"
+
+// project
+#include "JobSystem.hpp"
+#include "helpers/WorkStealingPool.hpp"
+#include "helpers/threadPlacement.hpp"
+
+namespace {
+    struct Options {
+        std::string renderCores;
+        std::string jobCores;
+        std::string jobPolicy = "normal";
+        int jobNice = 0;
+    };
+}
+
+#define refltype Options
+putils_reflection_info{
+    putils_reflection_custom_class_name(Placement);
+    putils_reflection_attributes(
+        putils_reflection_attribute(renderCores,
+            putils_reflection_metadata("help", "Cores the render thread may run on, e.g. \"0-1,4\" (defaults to all)")
+        ),
+        putils_reflection_attribute(jobCores,
+            putils_reflection_metadata("help", "Cores job threads may run on, e.g. \"2-3\" (defaults to all). Also sets the default number of job threads")
+        ),
+        putils_reflection_attribute(jobPolicy,
+            putils_reflection_metadata("help", "Scheduling policy of job threads, which also run parallel systems: \"normal\", \"batch\" or \"idle\" (may delay frames while cores are busy)")
+        ),
+        putils_reflection_attribute(jobNice,
+            putils_reflection_metadata("help", "Nice value of job threads (Linux only)")
+        )
+    );
+};
+#undef refltype
+
+namespace {
+    struct impl {
+        struct Settings {
+            // Masks of the first 64 cores, 0 for all
+            uint64_t renderCores = 0;
+            uint64_t jobCores = 0;
+            // Stored as ints so they can be adjusted
+            int jobPolicy = 0;
+            int jobNice = 0;
+
+            bool operator==(const Settings &) const noexcept = default;
+        };
+
+        static inline Settings settings;
+
+        // Adjustables can't hold 64-bit masks, so each core the machine has (or the command-line mentions) gets a toggle
+        static constexpr size_t maxCores = 64;
+        static inline std::array<bool, maxCores> renderCoreToggles{};
+        static inline std::array<bool, maxCores> jobCoreToggles{};
+        static inline std::optional<Settings> applied;
+        static inline std::atomic<bool> applyFailed = false;
+
+        // Refreshed this often, as threads move between cores
+        static constexpr float refreshInterval = .5f;
+        static inline float timeSinceRefresh = refreshInterval;
+
+        // The render thread's, then each job thread's
+        static inline std::mutex placementsMutex;
+        static inline std::vector<threadPlacement::Placement> placements;
+        // Workers that haven't run the last refresh yet, e.g. busy with a long job, which no more refreshes are queued behind
+        static inline std::atomic<size_t> pendingProbes = 0;
+
+        static void init(kengine::Entity &system) noexcept {
+            threadPlacement::init();
+
+            const auto options = kengine::parseCommandLine<Options>();
+            settings.renderCores = parseCores(options.renderCores);
+            settings.jobCores = parseCores(options.jobCores);
+            settings.jobNice = options.jobNice;
+            if (options.jobPolicy == "batch")
+                settings.jobPolicy = (int)threadPlacement::Policy::Batch;
+            else if (options.jobPolicy == "idle")
+                settings.jobPolicy = (int)threadPlacement::Policy::Idle;
+            else if (options.jobPolicy != "normal")
+                kengine_logf(Error, "Placement", "Unknown job policy '%s', expected 'normal', 'batch' or 'idle'", options.jobPolicy.c_str());
+
+            kengine::AdjustableComponent adjustable{
+                "Placement", {
+                    { "Job policy (0: normal, 1: batch, 2: idle)", &settings.jobPolicy },
+                    { "Job nice", &settings.jobNice }
+                }
+            };
+            // No toggle set means all cores
+            const auto coreCount = getCoreCount();
+            for (size_t i = 0; i < coreCount; ++i) {
+                renderCoreToggles[i] = settings.renderCores & (uint64_t(1) << i);
+                adjustable.values.push_back({ ("Render thread on core " + std::to_string(i)).c_str(), &renderCoreToggles[i] });
+            }
+            for (size_t i = 0; i < coreCount; ++i) {
+                jobCoreToggles[i] = settings.jobCores & (uint64_t(1) << i);
+                adjustable.values.push_back({ ("Jobs on core " + std::to_string(i)).c_str(), &jobCoreToggles[i] });
+            }
+            system += std::move(adjustable);
+            system += kengine::functions::Execute{ update };
+            system += koverlay::SystemAccessComponent{ .mainThread = true };
+            system += koverlay::ProfilerSectionComponent{ "Threads", drawPlacements };
+        }
+
+        static uint64_t parseCores(const std::string &list) noexcept {
+            if (list.empty())
+                return 0;
+            const auto cores = threadPlacement::parseCores(list);
+            if (!cores) {
+                kengine_logf(Error, "Placement", "Invalid core list '%s', expected e.g. '0-3,6' with cores below 64", list.c_str());
+                return 0;
+            }
+            return *cores;
+        }
+
+        // Enough toggles for every core, and for every core set on the command-line, so that toggles and masks convert losslessly
+        static size_t getCoreCount() noexcept {
+            const auto highest = (size_t)std::max(std::bit_width(settings.renderCores), std::bit_width(settings.jobCores));
+            return std::min(maxCores, std::max<size_t>({ std::thread::hardware_concurrency(), highest, 1 }));
+        }
+
+        static uint64_t toMask(const std::array<bool, maxCores> &toggles) noexcept {
+            uint64_t mask = 0;
+            for (size_t i = 0; i < toggles.size(); ++i)
+                if (toggles[i])
+                    mask |= uint64_t(1) << i;
+            return mask;
+        }
+
+        static void update(float deltaTime) noexcept {
+            settings.renderCores = toMask(renderCoreToggles);
+            settings.jobCores = toMask(jobCoreToggles);
+            settings.jobPolicy = std::clamp(settings.jobPolicy, 0, 2);
+            if (applied != settings) {
+                apply();
+                applied = settings;
+                timeSinceRefresh = refreshInterval;
+            }
+
+            if (applyFailed.exchange(false))
+                kengine_log(Warning, "Placement", "Failed to apply some thread placement settings (raising priority again may require privileges)");
+
+            timeSinceRefresh += deltaTime;
+            if (timeSinceRefresh >= refreshInterval) {
+                timeSinceRefresh = 0.f;
+                refreshPlacements();
+            }
+        }
+
+        static void apply() noexcept {
+            if (!applied || applied->renderCores != settings.renderCores)
+                if (!threadPlacement::setCores(settings.renderCores))
+                    applyFailed = true;
+
+            // Workers can't tell jobs and parallel systems apart without a system call per task, so both run with the job policy
+            const auto jobSettings = settings;
+            getJobPool().runOnEachWorker([jobSettings](size_t) noexcept {
+                const bool cores = threadPlacement::setCores(jobSettings.jobCores);
+                const bool priority = threadPlacement::setPriority((threadPlacement::Policy)jobSettings.jobPolicy, jobSettings.jobNice);
+                if (!cores || !priority)
+                    applyFailed = true;
+            });
+        }
+
+        static void refreshPlacements() noexcept {
+            auto &pool = getJobPool();
+            {
+                const std::lock_guard lock(placementsMutex);
+                placements.resize(pool.getThreadCount() + 1);
+                placements[0] = threadPlacement::get();
+            }
+
+            if (pendingProbes.load(std::memory_order_acquire) > 0)
+                return;
+            pendingProbes = pool.getThreadCount();
+            pool.runOnEachWorker([](size_t index) noexcept {
+                const auto placement = threadPlacement::get();
+                {
+                    const std::lock_guard lock(placementsMutex);
+                    placements[index + 1] = placement;
+                }
+                pendingProbes.fetch_sub(1, std::memory_order_release);
+            });
+        }
+
+        static void drawPlacements() noexcept {
+            if (!ImGui::BeginTable("Threads", 5, ImGuiTableFlags_Borders | ImGuiTableFlags_RowBg))
+                return;
+
+            ImGui::TableSetupColumn("Thread");
+            ImGui::TableSetupColumn("Current core");
+            ImGui::TableSetupColumn("Allowed cores");
+            ImGui::TableSetupColumn("Policy");
+            ImGui::TableSetupColumn("Nice");
+            ImGui::TableHeadersRow();
+
+            const std::lock_guard lock(placementsMutex);
+            for (size_t i = 0; i < placements.size(); ++i) {
+                const auto &placement = placements[i];
+                ImGui::TableNextRow();
+                ImGui::TableNextColumn();
+                if (i == 0)
+                    ImGui::TextUnformatted("Render");
+                else
+                    ImGui::Text("Job %zu", i - 1);
+                ImGui::TableNextColumn();
+                ImGui::Text("%d", placement.currentCore);
+                ImGui::TableNextColumn();
+                ImGui::TextUnformatted(threadPlacement::formatCores(placement.cores).c_str());
+                ImGui::TableNextColumn();
+                ImGui::TextUnformatted(threadPlacement::getPolicyName(placement.policy));
+                ImGui::TableNextColumn();
+                ImGui::Text("%d", placement.nice);
+            }
+            ImGui::EndTable();
+        }
+    };
+}
+
+kengine::EntityCreator * ThreadPlacementSystem() noexcept {
+	return impl::init;
+}
+
+size_t getJobCoreCount() noexcept {
+    return (size_t)std::popcount(impl::settings.jobCores);
+}
@@ -0,0 +1,13 @@
+#pragma once
+
+// stl
+#include <cstddef>
+
+#include "EntityCreator.hpp"
+
+// Pins the render thread and job threads to chosen cores, and lowers the job threads' priority, from the command-line or adjustables
+// Must be added before JobSystem, which uses getJobCoreCount
+kengine::EntityCreator * ThreadPlacementSystem() noexcept;
+
+// Number of cores job threads are restricted to, or 0 if they aren't
+size_t getJobCoreCount() noexcept;
@@ -0,0 +1,112 @@
+#include "ToolIndexSystem.hpp"
+#include "kengine.hpp"
+
+// stl
+#include <algorithm>
+#include <string_view>
+
+// kengine data
+#include "data/ImGuiToolComponent.hpp"
+#include "data/NameComponent.hpp"
+
+// api
+#include "ComponentEventsComponent.hpp"
+#include "EnabledToolsComponent.hpp"
+#include "ToolIndexComponent.hpp"
+
+namespace {
+    struct impl {
+        static inline kengine::EntityID indexEntity = kengine::INVALID_ID;
+        static inline bool batching = false;
+
+        static void init(kengine::Entity & system) noexcept {
+            indexEntity = system.id;
+
+            auto & index = system.attach<koverlay::ToolIndexComponent>();
+            auto & enabledTools = system.attach<koverlay::EnabledToolsComponent>();
+            for (const auto & [e, name, tool] : kengine::entities.with<kengine::NameComponent, kengine::ImGuiToolComponent>()) {
+                insert(index, e.id, name);
+                if (tool.enabled)
+                    enabledTools.insert(e.id);
+            }
+
+            koverlay::componentEvents::subscribe<kengine::ImGuiToolComponent>({
+                .onAttach = [](kengine::Entity & e, kengine::ImGuiToolComponent & tool) noexcept {
+                    if (const auto name = e.tryGet<kengine::NameComponent>())
+                        insert(getIndex(), e.id, *name);
+                    if (tool.enabled)
+                        getEnabledTools().insert(e.id);
+                },
+                .onDetach = [](kengine::Entity & e, kengine::ImGuiToolComponent &) noexcept {
+                    erase(getIndex(), e.id);
+                    getEnabledTools().erase(e.id);
+                },
+                .onModified = [](kengine::Entity & e, kengine::ImGuiToolComponent & tool) noexcept {
+                    if (tool.enabled)
+                        getEnabledTools().insert(e.id);
+                    else
+                        getEnabledTools().erase(e.id);
+                }
+            });
+
+            koverlay::componentEvents::subscribe<kengine::NameComponent>({
+                .onModified = [](kengine::Entity & e, kengine::NameComponent & name) noexcept {
+                    auto & index = getIndex();
+                    if (erase(index, e.id))
+                        insert(index, e.id, name);
+                }
+            });
+        }
+
+        static koverlay::ToolIndexComponent & getIndex() noexcept {
+            return kengine::entities[indexEntity].get<koverlay::ToolIndexComponent>();
+        }
+
+        static koverlay::EnabledToolsComponent & getEnabledTools() noexcept {
+            return kengine::entities[indexEntity].get<koverlay::EnabledToolsComponent>();
+        }
+
+        static bool erase(koverlay::ToolIndexComponent & index, kengine::EntityID id) noexcept {
+            const auto it = std::find_if(index.entries.begin(), index.entries.end(), [&](const auto & entry) noexcept {
+                return entry.id == id;
+            });
+            if (it == index.entries.end())
+                return false;
+            index.entries.erase(it);
+            return true;
+        }
+
+        static void insert(koverlay::ToolIndexComponent & index, kengine::EntityID id, const kengine::NameComponent & name) noexcept {
+            if (batching) {
+                index.entries.push_back({ id, name.name });
+                return;
+            }
+
+            const std::string_view key = name.name.c_str();
+            const auto it = std::upper_bound(index.entries.begin(), index.entries.end(), key, [](std::string_view key, const auto & entry) noexcept {
+                return key < std::string_view(entry.name.c_str());
+            });
+            index.entries.insert(it, { id, name.name });
+        }
+    };
+}
+
+kengine::EntityCreator * ToolIndexSystem() noexcept {
+    return impl::init;
+}
+
+void beginToolBatch(size_t count) noexcept {
+    auto & entries = impl::getIndex().entries;
+    entries.reserve(entries.size() + count);
+    auto & enabledTools = impl::getEnabledTools();
+    enabledTools.ids.reserve(enabledTools.ids.size() + count);
+    impl::batching = true;
+}
+
+void endToolBatch() noexcept {
+    impl::batching = false;
+    auto & entries = impl::getIndex().entries;
+    std::stable_sort(entries.begin(), entries.end(), [](const auto & lhs, const auto & rhs) noexcept {
+        return std::string_view(lhs.name.c_str()) < std::string_view(rhs.name.c_str());
+    });
+}
@@ -0,0 +1,9 @@
+#pragma once
+
+#include "EntityCreator.hpp"
+
+kengine::EntityCreator * ToolIndexSystem() noexcept;
+
+// While a batch is open, new tools are appended to the index unsorted. Closing the batch sorts the index once
+void beginToolBatch(size_t count) noexcept;
+void endToolBatch() noexcept;
@@ -0,0 +1,55 @@
+#include "ToolMenuSystem.hpp"
+#include "kengine.hpp"
+
+// stl
+#include <vector>
+
+// kengine data
+#include "data/ImGuiToolComponent.hpp"
+
+// kengine functions
+#include "functions/Execute.hpp"
+
+// imgui
+#include "imgui.h"
+
+// api
+#include "ComponentEventsComponent.hpp"
+#include "ToolIndexComponent.hpp"
+
+namespace {
+    struct impl {
+        static void init(kengine::Entity & system) noexcept {
+            system += kengine::functions::Execute{ execute };
+        }
+
+        static void execute(float deltaTime) noexcept {
+            // Toggled once the menu is closed, as observers may create or remove tools, which invalidates the index
+            static std::vector<kengine::EntityID> toggled;
+            toggled.clear();
+
+            if (ImGui::BeginMainMenuBar()) {
+                if (ImGui::BeginMenu("Tools")) {
+                    for (const auto & entry : koverlay::getSortedTools()) {
+                        const auto & tool = kengine::entities[entry.id].get<kengine::ImGuiToolComponent>();
+                        if (ImGui::MenuItem(entry.name.c_str(), nullptr, tool.enabled))
+                            toggled.push_back(entry.id);
+                    }
+                    ImGui::EndMenu();
+                }
+                ImGui::EndMainMenuBar();
+            }
+
+            for (const auto id : toggled) {
+                auto e = kengine::entities[id];
+                auto & tool = e.get<kengine::ImGuiToolComponent>();
+                tool.enabled = !tool.enabled;
+                koverlay::componentEvents::notifyModified<kengine::ImGuiToolComponent>(e);
+            }
+        }
+    };
+}
+
+kengine::EntityCreator * ToolMenuSystem() noexcept {
+    return impl::init;
+}
@@ -0,0 +1,7 @@
+#pragma once
+
+#include "EntityCreator.hpp"
+
+// Lists tools in the main menu bar's "Tools" menu, in name order, and notifies ImGuiToolComponent changes when one is toggled
+// Replaces kengine's ImGuiToolSystem, whose menu writes `enabled` without notifying anyone
+kengine::EntityCreator * ToolMenuSystem() noexcept;
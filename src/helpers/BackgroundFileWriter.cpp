@@ -0,0 +1,113 @@
+#include "BackgroundFileWriter.hpp"
+
+// stl
+#include <filesystem>
+#include <fstream>
+
+// kengine helpers
+#include "helpers/logHelper.hpp"
+
+BackgroundFileWriter::BackgroundFileWriter() noexcept
+    : _thread([this] { run(); })
+{}
+
+BackgroundFileWriter::~BackgroundFileWriter() noexcept {
+    flush();
+    {
+        const std::lock_guard lock(_mutex);
+        _stop = true;
+    }
+    _cv.notify_all();
+    _thread.join();
+}
+
+void BackgroundFileWriter::write(const std::string & path, std::string data) noexcept {
+    {
+        const std::lock_guard lock(_mutex);
+        _pending[path] = std::move(data);
+    }
+    _cv.notify_all();
+}
+
+void BackgroundFileWriter::flush() noexcept {
+    std::unique_lock lock(_mutex);
+    _cv.wait(lock, [this] { return _pending.empty() && !_writing; });
+}
+
+bool BackgroundFileWriter::idle() noexcept {
+    const std::lock_guard lock(_mutex);
+    return _pending.empty() && !_writing;
+}
+
+void BackgroundFileWriter::logErrors() noexcept {
+    std::vector<std::string> errors;
+    {
+        const std::lock_guard lock(_mutex);
+        errors.swap(_errors);
+    }
+    for (const auto & error : errors)
+        kengine_logf(Error, "Files", "%s", error.c_str());
+}
+
+// Returns an error message, or an empty string on success
+static std::string tryWriteFileAtomically(const std::string & linkPath, std::string_view data) noexcept;
+
+void BackgroundFileWriter::run() noexcept {
+    std::unique_lock lock(_mutex);
+    while (true) {
+        _cv.wait(lock, [this] { return _stop || !_pending.empty(); });
+        if (_pending.empty()) // _stop
+            return;
+
+        const auto node = _pending.extract(_pending.begin());
+        _writing = true;
+        lock.unlock();
+        auto error = tryWriteFileAtomically(node.key(), node.mapped());
+        lock.lock();
+        if (!error.empty())
+            _errors.push_back(std::move(error));
+        _writing = false;
+        _cv.notify_all();
+    }
+}
+
+BackgroundFileWriter & backgroundFileWriter() noexcept {
+    static BackgroundFileWriter writer;
+    return writer;
+}
+
+// Symbolic links are followed, so that renaming replaces the file they point to rather than the link itself
+static std::filesystem::path resolveLinks(std::filesystem::path path) noexcept {
+    std::error_code ec;
+    for (int i = 0; i < 16 && std::filesystem::is_symlink(path, ec); ++i) {
+        const auto target = std::filesystem::read_symlink(path, ec);
+        if (ec)
+            break;
+        path = target.is_absolute() ? target : path.parent_path() / target;
+    }
+    return path;
+}
+
+static std::string tryWriteFileAtomically(const std::string & linkPath, std::string_view data) noexcept {
+    const auto path = resolveLinks(linkPath).string();
+    const auto tmp = path + ".tmp";
+    {
+        std::ofstream f(tmp, std::ios::binary | std::ios::trunc);
+        f.write(data.data(), (std::streamsize)data.size());
+        if (!f)
+            return "Failed to write " + tmp;
+    }
+
+    std::error_code ec;
+    std::filesystem::rename(tmp, path, ec);
+    if (ec)
+        return "Failed to replace " + path + ": " + ec.message();
+    return {};
+}
+
+bool writeFileAtomically(const std::string & path, std::string_view data) noexcept {
+    const auto error = tryWriteFileAtomically(path, data);
+    if (!error.empty())
+        kengine_logf(Error, "Files", "%s", error.c_str());
+    return error.empty();
+}
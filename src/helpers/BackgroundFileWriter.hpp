@@ -0,0 +1,46 @@
+#pragma once
+
+// stl
+#include <condition_variable>
+#include <mutex>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+// Writes files on a worker thread. Each file is written to a temporary path then renamed over the target,
+// so readers never see a partial file. Writes queued for the same path are coalesced into the latest one
+// Symbolic links are followed, but renaming breaks hard links: files shared between directories must be symlinked
+class BackgroundFileWriter {
+public:
+    BackgroundFileWriter() noexcept;
+    ~BackgroundFileWriter() noexcept;
+
+    void write(const std::string & path, std::string data) noexcept;
+
+    // Blocks until every queued write has completed
+    void flush() noexcept;
+
+    bool idle() noexcept;
+
+    // Logs the writes that failed since the last call. kengine's logging isn't thread-safe, so the worker thread
+    // only queues its errors: this must be called from the main thread
+    void logErrors() noexcept;
+
+private:
+    void run() noexcept;
+
+    std::mutex _mutex;
+    std::condition_variable _cv;
+    std::unordered_map<std::string, std::string> _pending;
+    std::vector<std::string> _errors;
+    bool _writing = false;
+    bool _stop = false;
+    std::thread _thread;
+};
+
+BackgroundFileWriter & backgroundFileWriter() noexcept;
+
+// Logs errors, so must be called from the main thread
+bool writeFileAtomically(const std::string & path, std::string_view data) noexcept;
@@ -0,0 +1,109 @@
+#include "ChildProcess.hpp"
+
+// stl
+#include <cstring>
+#include <thread>
+#include <utility>
+#include <vector>
+
+#ifdef _WIN32
+# include <windows.h>
+#else
+# include <signal.h>
+# include <spawn.h>
+# include <sys/wait.h>
+extern char ** environ;
+#endif
+
+// kengine helpers
+#include "helpers/logHelper.hpp"
+
+ChildProcess::ChildProcess(const char * executable, std::span<const std::string> arguments) noexcept {
+#ifdef _WIN32
+    std::string commandLine = std::string("\"") + executable + '"';
+    for (const auto & arg : arguments)
+        commandLine += " \"" + arg + '"';
+
+    STARTUPINFOA startupInfo{ .cb = sizeof(STARTUPINFOA) };
+    PROCESS_INFORMATION processInfo;
+    if (!CreateProcessA(executable, commandLine.data(), nullptr, nullptr, FALSE, 0, nullptr, nullptr, &startupInfo, &processInfo)) {
+        kengine_logf(Error, "Process", "Failed to start %s (error %lu)", executable, GetLastError());
+        return;
+    }
+    CloseHandle(processInfo.hThread);
+    _process = processInfo.hProcess;
+#else
+    std::vector<char *> argv;
+    argv.push_back(const_cast<char *>(executable));
+    for (const auto & arg : arguments)
+        argv.push_back(const_cast<char *>(arg.c_str()));
+    argv.push_back(nullptr);
+
+    pid_t pid;
+    const int err = posix_spawn(&pid, executable, nullptr, nullptr, argv.data(), environ);
+    if (err != 0) {
+        kengine_logf(Error, "Process", "Failed to start %s: %s", executable, strerror(err));
+        return;
+    }
+    _pid = pid;
+#endif
+}
+
+ChildProcess::~ChildProcess() noexcept {
+    terminate();
+}
+
+ChildProcess::ChildProcess(ChildProcess && other) noexcept {
+    *this = std::move(other);
+}
+
+ChildProcess & ChildProcess::operator=(ChildProcess && other) noexcept {
+#ifdef _WIN32
+    std::swap(_process, other._process);
+#else
+    std::swap(_pid, other._pid);
+#endif
+    return *this;
+}
+
+ChildProcess::operator bool() const noexcept {
+#ifdef _WIN32
+    return _process != nullptr;
+#else
+    return _pid > 0;
+#endif
+}
+
+bool ChildProcess::running() noexcept {
+#ifdef _WIN32
+    return _process != nullptr && WaitForSingleObject(_process, 0) == WAIT_TIMEOUT;
+#else
+    if (_pid <= 0)
+        return false;
+    if (waitpid(_pid, nullptr, WNOHANG) == 0)
+        return true;
+    _pid = -1; // reaped
+    return false;
+#endif
+}
+
+void ChildProcess::terminate(std::chrono::milliseconds grace) noexcept {
+    const auto deadline = std::chrono::steady_clock::now() + grace;
+    while (running() && std::chrono::steady_clock::now() < deadline)
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+
+#ifdef _WIN32
+    if (_process == nullptr)
+        return;
+    if (running())
+        TerminateProcess(_process, 1);
+    CloseHandle(_process);
+    _process = nullptr;
+#else
+    if (_pid <= 0)
+        return;
+    kill(_pid, SIGKILL);
+    waitpid(_pid, nullptr, 0);
+    _pid = -1;
+#endif
+}
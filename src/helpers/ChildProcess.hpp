@@ -0,0 +1,32 @@
+#pragma once
+
+// stl
+#include <chrono>
+#include <span>
+#include <string>
+
+// Process started by the overlay, terminated on destruction if it's still running
+class ChildProcess {
+public:
+    ChildProcess() noexcept = default;
+    ChildProcess(const char * executable, std::span<const std::string> arguments) noexcept;
+    ~ChildProcess() noexcept;
+
+    ChildProcess(ChildProcess && other) noexcept;
+    ChildProcess & operator=(ChildProcess && other) noexcept;
+    ChildProcess(const ChildProcess &) = delete;
+    ChildProcess & operator=(const ChildProcess &) = delete;
+
+    explicit operator bool() const noexcept;
+    bool running() noexcept;
+
+    // Gives the process `grace` to exit on its own, then kills it
+    void terminate(std::chrono::milliseconds grace = std::chrono::milliseconds(0)) noexcept;
+
+private:
+#ifdef _WIN32
+    void * _process = nullptr;
+#else
+    int _pid = -1;
+#endif
+};
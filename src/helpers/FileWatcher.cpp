@@ -0,0 +1,117 @@
+#include "FileWatcher.hpp"
+
+// stl
+#include <filesystem>
+#include <utility>
+
+#ifdef __linux__
+# include <sys/inotify.h>
+# include <unistd.h>
+#endif
+
+FileWatcher::FileWatcher() noexcept {
+#ifdef __linux__
+    _inotify = inotify_init1(IN_NONBLOCK | IN_CLOEXEC);
+#endif
+}
+
+FileWatcher::~FileWatcher() noexcept {
+#ifdef __linux__
+    if (_inotify >= 0)
+        close(_inotify);
+#endif
+}
+
+FileWatcher::ID FileWatcher::add(const std::string & path) noexcept {
+    ID id = 0;
+    while (id < _entries.size() && _entries[id].used)
+        ++id;
+    if (id == _entries.size())
+        _entries.emplace_back();
+
+    auto & entry = _entries[id];
+    entry = Entry{ .path = path, .used = true };
+    if (_inotify >= 0)
+        watch(entry);
+    else
+        pollStat(entry);
+    return id;
+}
+
+void FileWatcher::remove(ID id) noexcept {
+    auto & entry = _entries[id];
+#ifdef __linux__
+    if (entry.watch >= 0)
+        inotify_rm_watch(_inotify, entry.watch);
+#endif
+    entry = Entry{};
+}
+
+void FileWatcher::poll(const std::function<void(ID)> & onChanged) noexcept {
+#ifdef __linux__
+    if (_inotify >= 0) {
+        alignas(inotify_event) char buffer[4096];
+        ssize_t length;
+        while ((length = read(_inotify, buffer, sizeof(buffer))) > 0) {
+            for (ssize_t offset = 0; offset < length;) {
+                const auto event = (const inotify_event *)(buffer + offset);
+                offset += sizeof(inotify_event) + event->len;
+
+                for (ID id = 0; id < _entries.size(); ++id) {
+                    auto & entry = _entries[id];
+                    if (!entry.used || entry.watch != event->wd)
+                        continue;
+                    // The file was deleted or renamed, so whatever now has its path is a new file
+                    if (event->mask & (IN_MOVE_SELF | IN_DELETE_SELF | IN_IGNORED)) {
+                        if (!(event->mask & IN_IGNORED))
+                            inotify_rm_watch(_inotify, entry.watch);
+                        entry.watch = -1;
+                    }
+                    onChanged(id);
+                }
+            }
+        }
+
+        // Files that don't exist (yet, or anymore) are looked for again
+        for (ID id = 0; id < _entries.size(); ++id) {
+            auto & entry = _entries[id];
+            if (entry.used && entry.watch < 0 && watch(entry))
+                onChanged(id);
+        }
+        return;
+    }
+#endif
+
+    const auto now = std::chrono::steady_clock::now();
+    if (now - _lastPoll < pollInterval)
+        return;
+    _lastPoll = now;
+
+    for (ID id = 0; id < _entries.size(); ++id) {
+        auto & entry = _entries[id];
+        if (entry.used && pollStat(entry))
+            onChanged(id);
+    }
+}
+
+bool FileWatcher::watch(Entry & entry) noexcept {
+#ifdef __linux__
+    entry.watch = inotify_add_watch(_inotify, entry.path.c_str(), IN_MODIFY | IN_ATTRIB | IN_CLOSE_WRITE | IN_MOVE_SELF | IN_DELETE_SELF);
+    return entry.watch >= 0;
+#else
+    return false;
+#endif
+}
+
+bool FileWatcher::pollStat(Entry & entry) noexcept {
+    std::error_code ec;
+    const uint64_t size = std::filesystem::file_size(entry.path, ec);
+    if (ec)
+        return std::exchange(entry.size, 0) != 0;
+
+    const int64_t modificationTime = std::filesystem::last_write_time(entry.path, ec).time_since_epoch().count();
+    const bool changed = size != entry.size || modificationTime != entry.modificationTime;
+    entry.size = size;
+    entry.modificationTime = modificationTime;
+    return changed;
+}
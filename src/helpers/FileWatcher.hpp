@@ -0,0 +1,46 @@
+#pragma once
+
+// stl
+#include <chrono>
+#include <cstdint>
+#include <functional>
+#include <string>
+#include <vector>
+
+// Reports changes to individual files: through inotify on Linux, and by polling their size and modification time elsewhere
+// Files that are deleted or renamed (e.g. by log rotation) are watched again once a file with the same path appears
+class FileWatcher {
+public:
+    using ID = size_t;
+
+    FileWatcher() noexcept;
+    ~FileWatcher() noexcept;
+
+    FileWatcher(const FileWatcher &) = delete;
+    FileWatcher & operator=(const FileWatcher &) = delete;
+
+    ID add(const std::string & path) noexcept;
+    void remove(ID id) noexcept;
+
+    // Calls `onChanged` for each file that may have changed since the last call
+    void poll(const std::function<void(ID)> & onChanged) noexcept;
+
+private:
+    struct Entry {
+        std::string path;
+        bool used = false;
+        int watch = -1; // inotify watch descriptor, -1 until the file exists
+        uint64_t size = 0;
+        int64_t modificationTime = 0;
+    };
+
+    bool watch(Entry & entry) noexcept;
+    bool pollStat(Entry & entry) noexcept;
+
+    std::vector<Entry> _entries;
+    int _inotify = -1;
+
+    // Without inotify, files are only stat'ed this often
+    static constexpr std::chrono::milliseconds pollInterval{ 250 };
+    std::chrono::steady_clock::time_point _lastPoll;
+};
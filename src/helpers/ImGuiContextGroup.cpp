@@ -0,0 +1,125 @@
+#include "ImGuiContextGroup.hpp"
+
+// stl
+#include <cctype>
+#include <cstdio>
+#include <unordered_map>
+
+#include "imgui_internal.h"
+
+namespace {
+    // Makes `context` current for the rest of the scope
+    struct ContextScope {
+        ImGuiContext * previous = ImGui::GetCurrentContext();
+
+        explicit ContextScope(ImGuiContext * context) noexcept { ImGui::SetCurrentContext(context); }
+        ~ContextScope() noexcept { ImGui::SetCurrentContext(previous); }
+    };
+}
+
+ImGuiContextGroup::ImGuiContextGroup(const std::string & name) noexcept
+    : _name(name)
+{
+    // The group's windows don't exist in the overlay's context, so their settings are saved separately
+    _iniFilename = "imgui.";
+    for (const auto c : name)
+        _iniFilename += std::isalnum((unsigned char)c) ? c : '_';
+    _iniFilename += ".ini";
+
+    _context = ImGui::CreateContext(ImGui::GetIO().Fonts);
+    const ContextScope scope(_context);
+    auto & io = ImGui::GetIO();
+    io.IniFilename = _iniFilename.c_str();
+    io.BackendFlags |= ImGuiBackendFlags_RendererHasVtxOffset; // handled when compositing
+}
+
+ImGuiContextGroup::~ImGuiContextGroup() noexcept {
+    const ContextScope scope(nullptr);
+    ImGui::DestroyContext(_context);
+}
+
+void ImGuiContextGroup::beginFrame() noexcept {
+    const auto & overlayIO = ImGui::GetIO();
+    const auto & overlayStyle = ImGui::GetStyle();
+
+    // Input from the previous frame's hover and focus state, as the group's windows are submitted after they're drawn
+    const bool active = _context->ActiveId != 0 || _context->MovingWindow != nullptr;
+    const auto input = drawDataTransport::captureInput({ 0.f, 0.f }, overlayIO.DisplaySize, _hovered, active, _focused);
+
+    const ContextScope scope(_context);
+    ImGui::GetStyle() = overlayStyle;
+    auto & io = ImGui::GetIO();
+    io.ConfigFlags = overlayIO.ConfigFlags;
+    io.FontGlobalScale = overlayIO.FontGlobalScale;
+    io.FontDefault = overlayIO.FontDefault;
+
+    drawDataTransport::applyInput(input, _previousInput);
+    _previousInput = input;
+    ImGui::NewFrame();
+}
+
+void ImGuiContextGroup::endFrame() noexcept {
+    const ImDrawData * drawData;
+    const ImDrawList * background;
+    {
+        const ContextScope scope(_context);
+        ImGui::Render();
+        drawData = ImGui::GetDrawData();
+        background = ImGui::GetBackgroundDrawList(ImGui::GetMainViewport());
+    }
+
+    static std::unordered_map<const ImDrawList *, const ImGuiWindow *> owners;
+    owners.clear();
+    for (const auto window : _context->Windows)
+        if (window->Active)
+            owners[window->DrawList] = window;
+
+    _hovered = _focused = false;
+    const ImGuiWindow * currentRoot = nullptr;
+
+    const auto endOverlayWindow = [&]() noexcept {
+        if (!currentRoot)
+            return;
+        ImGui::GetWindowDrawList()->PopClipRect();
+        ImGui::End();
+        currentRoot = nullptr;
+    };
+
+    // Draw lists are ordered back to front, with a root window's lists followed by its children's
+    for (int i = 0; i < drawData->CmdListsCount; ++i) {
+        const auto & list = *drawData->CmdLists[i];
+
+        const auto owner = owners.find(&list);
+        if (owner == owners.end()) { // the group's background or foreground draw list
+            endOverlayWindow();
+            const auto viewport = ImGui::GetMainViewport();
+            auto & target = &list == background ? *ImGui::GetBackgroundDrawList(viewport) : *ImGui::GetForegroundDrawList(viewport);
+            drawDataTransport::appendDrawList(list, target);
+            continue;
+        }
+
+        const auto root = owner->second->RootWindow;
+        if (root != currentRoot) {
+            endOverlayWindow();
+
+            char name[256];
+            snprintf(name, sizeof(name), "##%s_%08x", _name.c_str(), root->ID);
+            ImGui::SetNextWindowPos(root->Pos);
+            ImGui::SetNextWindowSize(root->Size);
+
+            auto flags = ImGuiWindowFlags_NoDecoration | ImGuiWindowFlags_NoBackground | ImGuiWindowFlags_NoMove |
+                ImGuiWindowFlags_NoSavedSettings | ImGuiWindowFlags_NoFocusOnAppearing | ImGuiWindowFlags_NoNav;
+            if (root->Flags & ImGuiWindowFlags_NoMouseInputs) // e.g. tooltips
+                flags |= ImGuiWindowFlags_NoInputs;
+
+            ImGui::Begin(name, nullptr, flags);
+            _hovered |= ImGui::IsWindowHovered();
+            _focused |= ImGui::IsWindowFocused();
+            // The group already clipped its own draw lists
+            ImGui::GetWindowDrawList()->PushClipRectFullScreen();
+            currentRoot = root;
+        }
+        drawDataTransport::appendDrawList(list, *ImGui::GetWindowDrawList());
+    }
+    endOverlayWindow();
+}
@@ -0,0 +1,39 @@
+#pragma once
+
+// stl
+#include <string>
+
+#include "imgui.h"
+
+// project
+#include "drawDataTransport.hpp"
+
+// ImGui context of its own for a group of ImGui plugins, so that groups can be drawn in parallel
+// It shares the overlay's font atlas and style, and gets the overlay's input while one of its windows is hovered, focused or being used
+// Each of its windows is composited into an overlay window at the same place, which keeps them ordered with the overlay's own windows
+// `beginFrame` and `endFrame` use the overlay's context, so they must be called from the thread that draws it
+class ImGuiContextGroup {
+public:
+    explicit ImGuiContextGroup(const std::string & name) noexcept;
+    ~ImGuiContextGroup() noexcept;
+
+    ImGuiContextGroup(const ImGuiContextGroup &) = delete;
+    ImGuiContextGroup & operator=(const ImGuiContextGroup &) = delete;
+
+    // Starts a frame in the group's context, with the input the overlay's context received this frame
+    void beginFrame() noexcept;
+    // Drawn into by the group's plugins, from any one thread at a time, between `beginFrame` and `endFrame`
+    ImGuiContext & getContext() const noexcept { return *_context; }
+    // Renders the group's frame, and submits its windows to the overlay's context
+    void endFrame() noexcept;
+
+    const std::string & getName() const noexcept { return _name; }
+
+private:
+    std::string _name;
+    std::string _iniFilename;
+    ImGuiContext * _context = nullptr;
+    drawDataTransport::Input _previousInput;
+    bool _hovered = false;
+    bool _focused = false;
+};
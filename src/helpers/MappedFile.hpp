@@ -0,0 +1,30 @@
+#pragma once
+
+// stl
+#include <string_view>
+
+// Read-only memory mapping of a whole file
+class MappedFile {
+public:
+    MappedFile() noexcept = default;
+    explicit MappedFile(const char * path) noexcept;
+    ~MappedFile() noexcept;
+
+    MappedFile(MappedFile && other) noexcept;
+    MappedFile & operator=(MappedFile && other) noexcept;
+    MappedFile(const MappedFile &) = delete;
+    MappedFile & operator=(const MappedFile &) = delete;
+
+    explicit operator bool() const noexcept { return _data != nullptr; }
+    std::string_view view() const noexcept { return { _data, _size }; }
+
+private:
+    void close() noexcept;
+
+    const char * _data = nullptr;
+    size_t _size = 0;
+#ifdef _WIN32
+    void * _file = nullptr;
+    void * _mapping = nullptr;
+#endif
+};
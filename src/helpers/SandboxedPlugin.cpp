@@ -0,0 +1,153 @@
+#include "SandboxedPlugin.hpp"
+
+// stl
+#include <chrono>
+#include <cstdio>
+#include <cstring>
+#include <new>
+
+#ifdef _WIN32
+# include <windows.h>
+#else
+# include <unistd.h>
+#endif
+
+// kengine helpers
+#include "helpers/logHelper.hpp"
+
+namespace {
+#ifdef _WIN32
+    constexpr auto hostExecutable = "koverlay-plugin-host.exe";
+#else
+    constexpr auto hostExecutable = "./koverlay-plugin-host";
+#endif
+
+    // Time it's given to exit on its own before being killed
+    constexpr std::chrono::milliseconds hostExitTimeout{ 200 };
+
+    uint64_t getProcessID() noexcept {
+#ifdef _WIN32
+        return GetCurrentProcessId();
+#else
+        return (uint64_t)getpid();
+#endif
+    }
+}
+
+SandboxedPlugin::SandboxedPlugin(const std::string & path) noexcept {
+    static size_t channelCount = 0;
+    const auto name = "koverlay-" + std::to_string(getProcessID()) + '-' + std::to_string(channelCount++);
+
+    _memory = SharedMemory::create(name.c_str(), drawDataTransport::Channel::getSize());
+    if (!_memory) {
+        _error = "Failed to create shared memory";
+        kengine_logf(Error, "Sandbox", "Failed to create shared memory for %s", path.c_str());
+        return;
+    }
+
+    auto & channel = *new (_memory.data()) drawDataTransport::Channel{};
+    drawDataTransport::initChannel(channel);
+    channel.overlayProcess = getProcessID();
+
+    const std::string arguments[] = { path, name };
+    _process = ChildProcess(hostExecutable, arguments);
+    if (!_process)
+        _error = "Failed to start the plugin host";
+}
+
+SandboxedPlugin::~SandboxedPlugin() noexcept {
+    if (_memory)
+        getChannel().stop.store(1, std::memory_order_release);
+    _process.terminate(hostExitTimeout);
+}
+
+drawDataTransport::Channel & SandboxedPlugin::getChannel() const noexcept {
+    return *static_cast<drawDataTransport::Channel *>(_memory.data());
+}
+
+bool SandboxedPlugin::draw(const char * name, float scale) noexcept {
+    const auto start = std::chrono::steady_clock::now();
+
+    char title[256];
+    snprintf(title, sizeof(title), "%s (sandboxed, %.2f ms)###sandbox_%s", name, _transportTime, name);
+    ImGui::SetNextWindowSize({ 400.f * scale, 300.f * scale }, ImGuiCond_FirstUseEver);
+
+    bool open = true;
+    bool enabled = true;
+    if (ImGui::Begin(title, &open)) {
+        if (_error.empty())
+            checkHost();
+
+        if (!_error.empty())
+            ImGui::TextUnformatted(_error.c_str());
+        else {
+            const auto origin = ImGui::GetCursorScreenPos();
+            const auto size = ImGui::GetContentRegionAvail();
+            sendInput(origin, size, scale);
+
+            auto & channel = getChannel();
+            const auto frame = drawDataTransport::acquireFrame(channel, _front);
+            // Copied, as the plugin host may keep writing to it
+            drawDataTransport::FrameHeader header;
+            if (frame) {
+                std::memcpy(&header, frame, sizeof(header));
+                if (header.number != 0)
+                    enabled = header.enabled != 0;
+            }
+
+            auto & drawList = *ImGui::GetWindowDrawList();
+            drawList.PushClipRect(origin, { origin.x + size.x, origin.y + size.y }, true);
+            if (!frame || !drawDataTransport::appendFrame(*frame, drawList, origin, ImGui::GetIO().Fonts->TexID)) {
+                _error = "The plugin sent an invalid frame";
+                kengine_logf(Error, "Sandbox", "%s sent an invalid frame, stopping it", name);
+                _process.terminate();
+            }
+            drawList.PopClipRect();
+
+            if (size.x > 0.f && size.y > 0.f) {
+                ImGui::InvisibleButton("##plugin", size, ImGuiButtonFlags_MouseButtonLeft | ImGuiButtonFlags_MouseButtonRight | ImGuiButtonFlags_MouseButtonMiddle);
+                _hovered = ImGui::IsItemHovered();
+                _active = ImGui::IsItemActive();
+            }
+            _focused = ImGui::IsWindowFocused();
+
+            const auto compositeTime = std::chrono::duration<float, std::milli>(std::chrono::steady_clock::now() - start).count();
+            const auto frameTime = compositeTime + float(header.encodeNanoseconds) / 1'000'000.f;
+            _transportTime += (frameTime - _transportTime) * .05f;
+        }
+    }
+    ImGui::End();
+
+    return open && enabled;
+}
+
+void SandboxedPlugin::checkHost() noexcept {
+    if (!_process.running()) {
+        _error = "The plugin host has stopped";
+        kengine_log(Warning, "Sandbox", "A plugin host has stopped");
+        return;
+    }
+
+    auto & channel = getChannel();
+    if (_fontChecked || !channel.ready.load(std::memory_order_acquire))
+        return;
+    _fontChecked = true;
+
+    // The plugin host's draw lists use UVs into its own font atlas, drawn with the overlay's texture
+    unsigned char * pixels;
+    int width, height;
+    ImGui::GetIO().Fonts->GetTexDataAsAlpha8(&pixels, &width, &height);
+    if (channel.fontWidth != (uint32_t)width || channel.fontHeight != (uint32_t)height ||
+        channel.fontChecksum != drawDataTransport::getFontChecksum(pixels, width, height)) {
+        _error = "The plugin host's font atlas doesn't match the overlay's";
+        kengine_log(Error, "Sandbox", "Sandboxed plugins require the overlay to use ImGui's default font");
+        _process.terminate();
+    }
+}
+
+void SandboxedPlugin::sendInput(ImVec2 origin, ImVec2 size, float scale) const noexcept {
+    // Input from the previous frame's hover state, as the canvas is submitted after the plugin's draw lists
+    auto input = drawDataTransport::captureInput(origin, size, _hovered, _active, _focused);
+    input.scale = scale;
+    drawDataTransport::writeInput(getChannel(), input);
+}
@@ -0,0 +1,43 @@
+#pragma once
+
+// stl
+#include <string>
+
+// project
+#include "ChildProcess.hpp"
+#include "SharedMemory.hpp"
+#include "drawDataTransport.hpp"
+
+// ImGui plugin running in a `koverlay-plugin-host` process, so that it can't crash or corrupt the overlay
+// Its draw lists are composited into an overlay window, which forwards it its input
+class SandboxedPlugin {
+public:
+    explicit SandboxedPlugin(const std::string & path) noexcept;
+    ~SandboxedPlugin() noexcept;
+
+    SandboxedPlugin(const SandboxedPlugin &) = delete;
+    SandboxedPlugin & operator=(const SandboxedPlugin &) = delete;
+
+    // Draws the plugin's latest frame in a window titled `name`, and sends it this frame's input
+    // Returns false once the window is closed, either by the user or by the plugin
+    bool draw(const char * name, float scale) noexcept;
+
+    // Average time spent encoding and compositing a frame, in milliseconds
+    float getTransportTime() const noexcept { return _transportTime; }
+
+private:
+    drawDataTransport::Channel & getChannel() const noexcept;
+    void checkHost() noexcept;
+    void sendInput(ImVec2 origin, ImVec2 size, float scale) const noexcept;
+
+private:
+    SharedMemory _memory;
+    ChildProcess _process;
+    std::string _error;
+    uint32_t _front = drawDataTransport::initialFront;
+    bool _fontChecked = false;
+    bool _hovered = false;
+    bool _active = false;
+    bool _focused = false;
+    float _transportTime = 0.f;
+};
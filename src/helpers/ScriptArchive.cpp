@@ -0,0 +1,158 @@
+#include "ScriptArchive.hpp"
+
+// stl
+#include <algorithm>
+#include <cstring>
+#include <string>
+
+// project
+#include "BackgroundFileWriter.hpp"
+
+namespace {
+    constexpr uint32_t magic = 0x504b4f4b; // "KOKP"
+    constexpr uint32_t version = 1;
+
+    struct Header {
+        uint32_t magic;
+        uint32_t version;
+        uint32_t luaVersion;
+        uint32_t scriptCount;
+    };
+
+    // Followed by the script's name, tool name and category, then its chunk, each padded to 8 bytes
+    struct ScriptHeader {
+        uint8_t kind;
+        uint8_t enabled;
+        uint16_t padding = 0;
+        float cost;
+        uint32_t nameSize;
+        uint32_t toolNameSize;
+        uint32_t categorySize;
+        uint32_t padding2 = 0;
+        uint64_t chunkSize;
+        uint64_t hash;
+    };
+
+    constexpr size_t align(size_t size) noexcept {
+        return (size + 7) & ~size_t(7);
+    }
+
+    // Bounds-checked reads, as the archive may be truncated
+    struct Reader {
+        const char * current;
+        const char * end;
+
+        template<typename T>
+        const T * read() noexcept {
+            const auto bytes = readBytes(sizeof(T));
+            return bytes.size() == sizeof(T) ? reinterpret_cast<const T *>(bytes.data()) : nullptr;
+        }
+
+        std::string_view readBytes(uint64_t size) noexcept {
+            if (uint64_t(end - current) < size)
+                return {};
+            const std::string_view ret{ current, size_t(size) };
+            current += std::min<uint64_t>(align(size_t(size)), uint64_t(end - current));
+            return ret;
+        }
+    };
+}
+
+ScriptArchive::ScriptArchive(const char * path) noexcept
+    : _file(path)
+{
+    if (!_file) {
+        _error = "Failed to map the archive";
+        return;
+    }
+
+    const auto data = _file.view();
+    Reader reader{ data.data(), data.data() + data.size() };
+
+    const auto header = reader.read<Header>();
+    if (!header || header->magic != magic) {
+        _error = "Not a script archive";
+        return;
+    }
+    if (header->version != version) {
+        _error = "Unsupported archive version " + std::to_string(header->version);
+        return;
+    }
+    _luaVersion = header->luaVersion;
+
+    // The count isn't trusted until each script has been read
+    _scripts.reserve(std::min<size_t>(header->scriptCount, size_t(reader.end - reader.current) / sizeof(ScriptHeader)));
+    for (uint32_t i = 0; i < header->scriptCount; ++i) {
+        const auto scriptHeader = reader.read<ScriptHeader>();
+        if (!scriptHeader) {
+            _error = "Truncated archive";
+            return;
+        }
+
+        Script script;
+        script.kind = (Kind)scriptHeader->kind;
+        script.name = reader.readBytes(scriptHeader->nameSize);
+        script.manifest.name = reader.readBytes(scriptHeader->toolNameSize);
+        script.manifest.category = reader.readBytes(scriptHeader->categorySize);
+        script.manifest.enabled = scriptHeader->enabled;
+        script.manifest.cost = scriptHeader->cost;
+        script.chunk = reader.readBytes(scriptHeader->chunkSize);
+        script.hash = scriptHeader->hash;
+        if (script.chunk.size() != scriptHeader->chunkSize || script.chunk.empty()) {
+            _error = "Truncated archive";
+            return;
+        }
+        _scripts.push_back(std::move(script));
+    }
+}
+
+const ScriptArchive::Script * ScriptArchive::findModule(std::string_view name) const noexcept {
+    const auto it = std::ranges::find_if(_scripts, [&](const Script & script) noexcept {
+        return script.kind == Kind::Module && script.name == name;
+    });
+    return it != _scripts.end() ? &*it : nullptr;
+}
+
+bool ScriptArchive::isIntact(const Script & script) noexcept {
+    return hash(script.chunk) == script.hash;
+}
+
+// Replaced through a rename, as an overlay may have the previous version mapped, and would crash reading it once truncated
+bool ScriptArchive::write(const char * path, uint32_t luaVersion, std::span<const Script> scripts) noexcept {
+    std::string data;
+    const auto write = [&](const void * bytes, size_t size) noexcept {
+        data.append(static_cast<const char *>(bytes), size);
+        data.append(align(size) - size, '\0');
+    };
+
+    const Header header{ .magic = magic, .version = version, .luaVersion = luaVersion, .scriptCount = (uint32_t)scripts.size() };
+    write(&header, sizeof(header));
+
+    for (const auto & script : scripts) {
+        const ScriptHeader scriptHeader{
+            .kind = (uint8_t)script.kind,
+            .enabled = script.manifest.enabled,
+            .cost = script.manifest.cost,
+            .nameSize = (uint32_t)script.name.size(),
+            .toolNameSize = (uint32_t)script.manifest.name.size(),
+            .categorySize = (uint32_t)script.manifest.category.size(),
+            .chunkSize = script.chunk.size(),
+            .hash = hash(script.chunk)
+        };
+        write(&scriptHeader, sizeof(scriptHeader));
+        write(script.name.data(), script.name.size());
+        write(script.manifest.name.data(), script.manifest.name.size());
+        write(script.manifest.category.data(), script.manifest.category.size());
+        write(script.chunk.data(), script.chunk.size());
+    }
+    return writeFileAtomically(path, data);
+}
+
+uint64_t ScriptArchive::hash(std::string_view data) noexcept {
+    uint64_t ret = 14695981039346656037ull;
+    for (const auto c : data) {
+        ret ^= (unsigned char)c;
+        ret *= 1099511628211ull;
+    }
+    return ret;
+}
@@ -0,0 +1,54 @@
+#pragma once
+
+// stl
+#include <cstdint>
+#include <span>
+#include <string>
+#include <string_view>
+#include <vector>
+
+// project
+#include "MappedFile.hpp"
+#include "toolManifestHelper.hpp"
+
+// Single file holding precompiled Lua tools and modules, built by `koverlay-pack`
+// It's mapped rather than read, and its chunks are loaded straight from the mapping
+class ScriptArchive {
+public:
+    enum class Kind : uint8_t {
+        Tool, // a script in the scripts directory
+        Module, // a script in its `lib` subdirectory, found by `require`
+    };
+
+    struct Script {
+        Kind kind = Kind::Tool;
+        std::string name; // file name for tools, e.g. "example.lua", module name for modules, e.g. "format.numbers"
+        ToolManifest manifest; // tools only
+        std::string_view chunk; // Lua bytecode, as written by `lua_dump`
+        uint64_t hash = 0; // of `chunk`
+    };
+
+    ScriptArchive() noexcept = default;
+    // Check `getError` if the result is false
+    explicit ScriptArchive(const char * path) noexcept;
+
+    explicit operator bool() const noexcept { return _file && _error.empty(); }
+    const std::string & getError() const noexcept { return _error; }
+
+    // LUA_VERSION_NUM of the Lua that compiled the archive, whose bytecode other versions can't load
+    uint32_t getLuaVersion() const noexcept { return _luaVersion; }
+    const std::vector<Script> & getScripts() const noexcept { return _scripts; }
+    const Script * findModule(std::string_view name) const noexcept;
+
+    // Chunks are only checked against their hash when they're used, so opening an archive doesn't read it all
+    static bool isIntact(const Script & script) noexcept;
+
+    static bool write(const char * path, uint32_t luaVersion, std::span<const Script> scripts) noexcept;
+    static uint64_t hash(std::string_view data) noexcept;
+
+private:
+    MappedFile _file;
+    std::string _error;
+    uint32_t _luaVersion = 0;
+    std::vector<Script> _scripts;
+};
@@ -0,0 +1,55 @@
+#include "SharedLibrary.hpp"
+
+// stl
+#include <utility>
+
+#ifdef _WIN32
+# include <windows.h>
+#else
+# include <dlfcn.h>
+#endif
+
+// kengine helpers
+#include "helpers/logHelper.hpp"
+
+SharedLibrary::SharedLibrary(const char * path) noexcept {
+#ifdef _WIN32
+    _handle = LoadLibraryA(path);
+    if (_handle == nullptr)
+        kengine_logf(Error, "Plugins", "Failed to load %s (error %lu)", path, GetLastError());
+#else
+    // RTLD_LOCAL: plugins embed their own ImGui, which must not resolve to another plugin's
+    _handle = dlopen(path, RTLD_NOW | RTLD_LOCAL);
+    if (_handle == nullptr)
+        kengine_logf(Error, "Plugins", "Failed to load %s: %s", path, dlerror());
+#endif
+}
+
+SharedLibrary::~SharedLibrary() noexcept {
+    if (_handle == nullptr)
+        return;
+#ifdef _WIN32
+    FreeLibrary((HMODULE)_handle);
+#else
+    dlclose(_handle);
+#endif
+}
+
+SharedLibrary::SharedLibrary(SharedLibrary && other) noexcept
+    : _handle(std::exchange(other._handle, nullptr))
+{}
+
+SharedLibrary & SharedLibrary::operator=(SharedLibrary && other) noexcept {
+    std::swap(_handle, other._handle);
+    return *this;
+}
+
+void * SharedLibrary::getSymbol(const char * name) const noexcept {
+    if (_handle == nullptr)
+        return nullptr;
+#ifdef _WIN32
+    return (void *)GetProcAddress((HMODULE)_handle, name);
+#else
+    return dlsym(_handle, name);
+#endif
+}
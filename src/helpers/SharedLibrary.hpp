@@ -0,0 +1,35 @@
+#pragma once
+
+// stl
+#include <string_view>
+
+// Dynamically loaded library, unloaded on destruction
+class SharedLibrary {
+public:
+    SharedLibrary() noexcept = default;
+    explicit SharedLibrary(const char * path) noexcept;
+    ~SharedLibrary() noexcept;
+
+    SharedLibrary(SharedLibrary && other) noexcept;
+    SharedLibrary & operator=(SharedLibrary && other) noexcept;
+    SharedLibrary(const SharedLibrary &) = delete;
+    SharedLibrary & operator=(const SharedLibrary &) = delete;
+
+    explicit operator bool() const noexcept { return _handle != nullptr; }
+
+    void * getSymbol(const char * name) const noexcept;
+
+    template<typename Func>
+    Func * getFunction(const char * name) const noexcept {
+        return reinterpret_cast<Func *>(getSymbol(name));
+    }
+
+#ifdef _WIN32
+    static constexpr std::string_view extension = ".dll";
+#else
+    static constexpr std::string_view extension = ".so";
+#endif
+
+private:
+    void * _handle = nullptr;
+};
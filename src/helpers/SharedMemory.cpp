@@ -0,0 +1,132 @@
+#include "SharedMemory.hpp"
+
+// stl
+#include <utility>
+
+#ifdef _WIN32
+# include <windows.h>
+#else
+# include <fcntl.h>
+# include <sys/mman.h>
+# include <sys/stat.h>
+# include <unistd.h>
+#endif
+
+namespace {
+    std::string getSystemName(const char * name) noexcept {
+#ifdef _WIN32
+        return std::string("Local\\") + name;
+#else
+        return std::string("/") + name;
+#endif
+    }
+}
+
+SharedMemory SharedMemory::create(const char * name, size_t size) noexcept {
+    SharedMemory ret;
+    const auto systemName = getSystemName(name);
+#ifdef _WIN32
+    ret._mapping = CreateFileMappingA(INVALID_HANDLE_VALUE, nullptr, PAGE_READWRITE, (DWORD)((unsigned long long)size >> 32), (DWORD)size, systemName.c_str());
+    if (ret._mapping == nullptr)
+        return ret;
+    ret._data = MapViewOfFile(ret._mapping, FILE_MAP_ALL_ACCESS, 0, 0, size);
+    if (ret._data == nullptr) {
+        ret.close();
+        return ret;
+    }
+#else
+    const int fd = shm_open(systemName.c_str(), O_CREAT | O_EXCL | O_RDWR, 0600);
+    if (fd < 0)
+        return ret;
+    if (ftruncate(fd, (off_t)size) != 0) {
+        ::close(fd);
+        shm_unlink(systemName.c_str());
+        return ret;
+    }
+    const auto data = mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    ::close(fd);
+    if (data == MAP_FAILED) {
+        shm_unlink(systemName.c_str());
+        return ret;
+    }
+    ret._data = data;
+#endif
+    ret._size = size;
+    ret._name = name;
+    ret._owner = true;
+    return ret;
+}
+
+SharedMemory SharedMemory::open(const char * name) noexcept {
+    SharedMemory ret;
+    const auto systemName = getSystemName(name);
+#ifdef _WIN32
+    ret._mapping = OpenFileMappingA(FILE_MAP_ALL_ACCESS, FALSE, systemName.c_str());
+    if (ret._mapping == nullptr)
+        return ret;
+    ret._data = MapViewOfFile(ret._mapping, FILE_MAP_ALL_ACCESS, 0, 0, 0);
+    MEMORY_BASIC_INFORMATION info;
+    if (ret._data == nullptr || VirtualQuery(ret._data, &info, sizeof(info)) == 0) {
+        ret.close();
+        return ret;
+    }
+    ret._size = info.RegionSize;
+#else
+    const int fd = shm_open(systemName.c_str(), O_RDWR, 0600);
+    if (fd < 0)
+        return ret;
+    struct stat st;
+    if (fstat(fd, &st) == 0 && st.st_size > 0) {
+        const auto data = mmap(nullptr, st.st_size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+        if (data != MAP_FAILED) {
+            ret._data = data;
+            ret._size = (size_t)st.st_size;
+        }
+    }
+    ::close(fd);
+#endif
+    ret._name = name;
+    return ret;
+}
+
+SharedMemory::~SharedMemory() noexcept {
+    close();
+}
+
+SharedMemory::SharedMemory(SharedMemory && other) noexcept {
+    *this = std::move(other);
+}
+
+SharedMemory & SharedMemory::operator=(SharedMemory && other) noexcept {
+    if (this == &other)
+        return *this;
+
+    close();
+    std::swap(_data, other._data);
+    std::swap(_size, other._size);
+    std::swap(_name, other._name);
+    std::swap(_owner, other._owner);
+#ifdef _WIN32
+    std::swap(_mapping, other._mapping);
+#endif
+    return *this;
+}
+
+void SharedMemory::close() noexcept {
+#ifdef _WIN32
+    if (_data)
+        UnmapViewOfFile(_data);
+    if (_mapping)
+        CloseHandle(_mapping);
+    _mapping = nullptr;
+#else
+    if (_data)
+        munmap(_data, _size);
+    if (_owner)
+        shm_unlink(getSystemName(_name.c_str()).c_str());
+#endif
+    _data = nullptr;
+    _size = 0;
+    _name.clear();
+    _owner = false;
+}
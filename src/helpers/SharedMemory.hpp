@@ -0,0 +1,39 @@
+#pragma once
+
+// stl
+#include <cstddef>
+#include <string>
+
+// Named memory segment shared between processes
+// The segment is removed when the object that created it is destroyed
+class SharedMemory {
+public:
+    SharedMemory() noexcept = default;
+    ~SharedMemory() noexcept;
+
+    // Creates a zero-filled segment of `size` bytes
+    static SharedMemory create(const char * name, size_t size) noexcept;
+    // Maps an existing segment
+    static SharedMemory open(const char * name) noexcept;
+
+    SharedMemory(SharedMemory && other) noexcept;
+    SharedMemory & operator=(SharedMemory && other) noexcept;
+    SharedMemory(const SharedMemory &) = delete;
+    SharedMemory & operator=(const SharedMemory &) = delete;
+
+    explicit operator bool() const noexcept { return _data != nullptr; }
+    void * data() const noexcept { return _data; }
+    size_t size() const noexcept { return _size; }
+    const std::string & name() const noexcept { return _name; }
+
+private:
+    void close() noexcept;
+
+    void * _data = nullptr;
+    size_t _size = 0;
+    std::string _name;
+    bool _owner = false;
+#ifdef _WIN32
+    void * _mapping = nullptr;
+#endif
+};
@@ -0,0 +1,132 @@
+#include "WorkStealingPool.hpp"
+
+namespace {
+    // Index of the calling thread's queue, if it's one of this pool's workers
+    thread_local const WorkStealingPool * currentPool = nullptr;
+    thread_local size_t currentQueue = 0;
+}
+
+WorkStealingPool::WorkStealingPool(size_t threadCount) noexcept {
+    for (size_t i = 0; i < threadCount; ++i)
+        _queues.push_back(std::make_unique<Queue>());
+    for (size_t i = 0; i < threadCount; ++i)
+        _threads.emplace_back([this, i] { work(i); });
+}
+
+WorkStealingPool::~WorkStealingPool() noexcept {
+    {
+        const std::lock_guard lock(_sleepMutex);
+        _stopping = true;
+    }
+    _wakeUp.notify_all();
+    for (auto & thread : _threads)
+        thread.join();
+}
+
+void WorkStealingPool::push(Task task, Kind kind) noexcept {
+    {
+        // Counted before being queued, so `_pending` never underflows. Locked so a worker can't miss the notification between checking `_pending` and waiting
+        const std::lock_guard lock(_sleepMutex);
+        ++_pending;
+        if (kind == Kind::System)
+            ++_pendingSystem;
+    }
+
+    const auto index = currentPool == this ? currentQueue : _nextQueue++ % _queues.size();
+    {
+        auto & queue = *_queues[index];
+        const std::lock_guard lock(queue.mutex);
+        (kind == Kind::System ? queue.systemTasks : queue.jobs).push_back(std::move(task));
+    }
+    _wakeUp.notify_one();
+}
+
+void WorkStealingPool::runOnEachWorker(const std::function<void(size_t index)> & task) noexcept {
+    {
+        const std::lock_guard sleepLock(_sleepMutex);
+        for (size_t i = 0; i < _queues.size(); ++i) {
+            auto & queue = *_queues[i];
+            const std::lock_guard lock(queue.mutex);
+            queue.pinned.push_back([task, i] { task(i); });
+            ++queue.pinnedCount;
+        }
+    }
+    _wakeUp.notify_all();
+}
+
+bool WorkStealingPool::isWorkerThread() const noexcept {
+    return currentPool == this;
+}
+
+bool WorkStealingPool::runOne() noexcept {
+    Task task;
+    const bool isWorker = currentPool == this;
+    if (!take(isWorker ? currentQueue : 0, isWorker, task))
+        return false;
+    task();
+    return true;
+}
+
+void WorkStealingPool::work(size_t index) noexcept {
+    currentPool = this;
+    currentQueue = index;
+
+    Task task;
+    while (true) {
+        if (take(index, true, task)) {
+            task();
+            task = nullptr;
+            continue;
+        }
+
+        std::unique_lock lock(_sleepMutex);
+        _wakeUp.wait(lock, [this, index] { return _stopping || _pending > 0 || _queues[index]->pinnedCount > 0; });
+        if (_stopping)
+            return;
+    }
+}
+
+// Pinned task for worker `index`, or else a system task, or else a job (only for workers)
+bool WorkStealingPool::take(size_t index, bool isWorker, Task & task) noexcept {
+    if (isWorker && _queues[index]->pinnedCount > 0) {
+        auto & queue = *_queues[index];
+        const std::lock_guard lock(queue.mutex);
+        task = std::move(queue.pinned.front());
+        queue.pinned.pop_front();
+        --queue.pinnedCount;
+        return true;
+    }
+
+    if (_pendingSystem > 0 && take(index, &Queue::systemTasks, task)) {
+        --_pendingSystem;
+        return true;
+    }
+    return isWorker && take(index, &Queue::jobs, task);
+}
+
+// Newest task from queue `index`, or else oldest task from the other queues
+bool WorkStealingPool::take(size_t index, std::deque<Task> Queue::* tasks, Task & task) noexcept {
+    if (_pending == 0)
+        return false;
+
+    for (size_t i = 0; i < _queues.size(); ++i) {
+        const auto queueIndex = (index + i) % _queues.size();
+        auto & queue = *_queues[queueIndex];
+        const std::lock_guard lock(queue.mutex);
+        auto & queued = queue.*tasks;
+        if (queued.empty())
+            continue;
+
+        if (queueIndex == index) {
+            task = std::move(queued.back());
+            queued.pop_back();
+        }
+        else {
+            task = std::move(queued.front());
+            queued.pop_front();
+        }
+        --_pending;
+        return true;
+    }
+    return false;
+}
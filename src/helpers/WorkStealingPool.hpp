@@ -0,0 +1,63 @@
+#pragma once
+
+// stl
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+// Thread pool in which each worker has its own queue, and takes tasks from the other workers' queues once its own is empty
+// Tasks pushed from a worker go to that worker's queue, so related tasks tend to stay on the same thread
+// System tasks (i.e. parts of the current frame) are kept apart from jobs, which may run for much longer: workers run them first,
+// and threads outside the pool only ever help with them
+class WorkStealingPool {
+public:
+    using Task = std::function<void()>;
+    enum class Kind { System, Job };
+
+    explicit WorkStealingPool(size_t threadCount) noexcept;
+    ~WorkStealingPool() noexcept;
+
+    WorkStealingPool(const WorkStealingPool &) = delete;
+    WorkStealingPool & operator=(const WorkStealingPool &) = delete;
+
+    void push(Task task, Kind kind) noexcept;
+    // Runs `task(index)` once on each worker, e.g. to change the workers' priority
+    void runOnEachWorker(const std::function<void(size_t index)> & task) noexcept;
+
+    // Runs a queued task on the calling thread, if there is one, so threads waiting on tasks can help instead of blocking
+    // Workers may run any task, other threads only system tasks
+    bool runOne() noexcept;
+
+    size_t getThreadCount() const noexcept { return _threads.size(); }
+    bool isWorkerThread() const noexcept;
+
+private:
+    struct Queue {
+        std::mutex mutex;
+        std::deque<Task> systemTasks;
+        std::deque<Task> jobs;
+        // Only run by the queue's worker, and not counted in `_pending`
+        std::deque<Task> pinned;
+        std::atomic<size_t> pinnedCount = 0;
+    };
+
+    void work(size_t index) noexcept;
+    bool take(size_t index, bool isWorker, Task & task) noexcept;
+    bool take(size_t index, std::deque<Task> Queue::* tasks, Task & task) noexcept;
+
+    std::vector<std::unique_ptr<Queue>> _queues;
+    std::vector<std::thread> _threads;
+    std::atomic<size_t> _nextQueue = 0;
+
+    std::mutex _sleepMutex;
+    std::condition_variable _wakeUp;
+    // Queued tasks, and queued system tasks among them
+    std::atomic<size_t> _pending = 0;
+    std::atomic<size_t> _pendingSystem = 0;
+    bool _stopping = false;
+};
@@ -0,0 +1,18 @@
+#pragma once
+
+// stl
+#include <string>
+#include <string_view>
+
+// Compact binary encoding of reflectable types
+// Each reflected attribute is tagged with a hash of its name and its encoded size, so readers skip attributes they don't know about
+// and leave missing ones untouched. std::string_view members are read without copying and point into the source buffer
+namespace binarySnapshotHelper {
+    template<typename T>
+    void write(std::string & out, const T & obj) noexcept;
+
+    template<typename T>
+    bool read(std::string_view data, T & obj) noexcept;
+}
+
+#include "binarySnapshotHelper.inl"
@@ -0,0 +1,208 @@
+#include "binarySnapshotHelper.hpp"
+
+// stl
+#include <cstdint>
+#include <cstring>
+#include <type_traits>
+
+// putils
+#include "reflection.hpp"
+
+// project
+#include "serializationTraits.hpp"
+
+namespace binarySnapshotHelper {
+    namespace impl {
+        using namespace serializationTraits;
+
+        constexpr std::uint32_t hashName(std::string_view name) noexcept {
+            std::uint32_t hash = 2166136261u; // FNV-1a
+            for (const char c : name) {
+                hash ^= (unsigned char)c;
+                hash *= 16777619u;
+            }
+            return hash;
+        }
+
+        template<typename T>
+        void writeRaw(std::string & out, const T & value) noexcept {
+            out.append((const char *)&value, sizeof(value));
+        }
+
+        inline void writeString(std::string & out, std::string_view str) noexcept {
+            writeRaw(out, (std::uint32_t)str.size());
+            out.append(str);
+            out += '\0'; // lets readers hand out C strings straight from the buffer
+        }
+
+        template<typename T>
+        void writeValue(std::string & out, const T & value) noexcept {
+            if constexpr (std::is_arithmetic_v<T> || std::is_enum_v<T>)
+                writeRaw(out, value);
+            else if constexpr (StringView<T>)
+                writeString(out, std::string_view(value));
+            else if constexpr (CString<T>)
+                writeString(out, std::string_view(value.c_str()));
+            else if constexpr (isOptional<T>::value) {
+                writeRaw(out, (std::uint8_t)value.has_value());
+                if (value)
+                    writeValue(out, *value);
+            }
+            else if constexpr (putils::reflection::has_attributes<T>()) {
+                const auto countOffset = out.size();
+                std::uint32_t count = 0;
+                writeRaw(out, count);
+                putils::reflection::for_each_attribute(value, [&](const auto & attr) noexcept {
+                    writeRaw(out, hashName(attr.name));
+                    const auto sizeOffset = out.size();
+                    writeRaw(out, std::uint32_t(0));
+                    writeValue(out, attr.member);
+                    const auto size = std::uint32_t(out.size() - sizeOffset - sizeof(std::uint32_t));
+                    std::memcpy(out.data() + sizeOffset, &size, sizeof(size));
+                    ++count;
+                });
+                std::memcpy(out.data() + countOffset, &count, sizeof(count));
+            }
+            else if constexpr (Map<T>) {
+                writeRaw(out, (std::uint32_t)value.size());
+                for (const auto & [key, mapped] : value) {
+                    writeValue(out, key);
+                    writeValue(out, mapped);
+                }
+            }
+            else if constexpr (Range<const T>) {
+                const auto countOffset = out.size();
+                std::uint32_t count = 0;
+                writeRaw(out, count);
+                for (const auto & element : value) {
+                    writeValue(out, element);
+                    ++count;
+                }
+                std::memcpy(out.data() + countOffset, &count, sizeof(count));
+            }
+            else
+                static_assert(alwaysFalse<T>, "Type cannot be written to a binary snapshot");
+        }
+
+        struct Reader {
+            std::string_view data;
+            size_t pos = 0;
+
+            template<typename T>
+            bool readRaw(T & value) noexcept {
+                if (data.size() - pos < sizeof(T))
+                    return false;
+                std::memcpy(&value, data.data() + pos, sizeof(T));
+                pos += sizeof(T);
+                return true;
+            }
+
+            bool readString(std::string_view & out) noexcept {
+                std::uint32_t size;
+                if (!readRaw(size) || data.size() - pos < size + 1ull)
+                    return false;
+                out = data.substr(pos, size);
+                pos += size + 1;
+                return true;
+            }
+
+            template<typename T>
+            bool readValue(T & value) noexcept {
+                if constexpr (std::is_arithmetic_v<T> || std::is_enum_v<T>)
+                    return readRaw(value);
+                else if constexpr (StringView<T> || CString<T>) {
+                    std::string_view str;
+                    if (!readString(str))
+                        return false;
+                    if constexpr (std::is_assignable_v<T &, std::string_view>)
+                        value = str;
+                    else
+                        value = str.data(); // null-terminated by writeString
+                    return true;
+                }
+                else if constexpr (isOptional<T>::value) {
+                    std::uint8_t hasValue;
+                    if (!readRaw(hasValue))
+                        return false;
+                    if (!hasValue) {
+                        value.reset();
+                        return true;
+                    }
+                    if (!value)
+                        value.emplace();
+                    return readValue(*value);
+                }
+                else if constexpr (putils::reflection::has_attributes<T>()) {
+                    std::uint32_t count;
+                    if (!readRaw(count))
+                        return false;
+                    for (std::uint32_t i = 0; i < count; ++i) {
+                        std::uint32_t hash, size;
+                        if (!readRaw(hash) || !readRaw(size) || data.size() - pos < size)
+                            return false;
+
+                        Reader attributeReader{ .data = data.substr(0, pos + size), .pos = pos };
+                        bool ok = true;
+                        putils::reflection::for_each_attribute(value, [&](const auto & attr) noexcept {
+                            if (hashName(attr.name) == hash)
+                                ok = attributeReader.readValue(attr.member);
+                        });
+                        if (!ok)
+                            return false;
+                        pos += size;
+                    }
+                    return true;
+                }
+                else if constexpr (Map<T>) {
+                    std::uint32_t count;
+                    if (!readRaw(count))
+                        return false;
+                    value.clear();
+                    for (std::uint32_t i = 0; i < count; ++i) {
+                        typename T::key_type key;
+                        if (!readValue(key) || !readValue(value[key]))
+                            return false;
+                    }
+                    return true;
+                }
+                else if constexpr (Range<T>) {
+                    std::uint32_t count;
+                    if (!readRaw(count))
+                        return false;
+                    if constexpr (Resizable<T>) {
+                        value.clear();
+                        if constexpr (requires { value.reserve(count); })
+                            value.reserve(count);
+                        for (std::uint32_t i = 0; i < count; ++i)
+                            if (!readValue(value.emplace_back()))
+                                return false;
+                        return true;
+                    }
+                    else {
+                        std::uint32_t i = 0;
+                        for (auto & element : value) {
+                            if (i++ >= count)
+                                break;
+                            if (!readValue(element))
+                                return false;
+                        }
+                        return i >= count; // extra elements can't be skipped without knowing their size
+                    }
+                }
+                else
+                    static_assert(alwaysFalse<T>, "Type cannot be read from a binary snapshot");
+            }
+        };
+    }
+
+    template<typename T>
+    void write(std::string & out, const T & obj) noexcept {
+        impl::writeValue(out, obj);
+    }
+
+    template<typename T>
+    bool read(std::string_view data, T & obj) noexcept {
+        impl::Reader reader{ .data = data };
+        return reader.readValue(obj);
+    }
+}
@@ -0,0 +1,326 @@
+#include "drawDataTransport.hpp"
+
+// stl
+#include <algorithm>
+#include <chrono>
+#include <cstring>
+#include <iterator>
+#include <limits>
+#include <thread>
+
+namespace drawDataTransport {
+    namespace {
+        static constexpr uint32_t newFrameFlag = 4;
+        static constexpr uint32_t indexMask = 3;
+
+        struct ListHeader {
+            uint32_t vertexCount;
+            uint32_t indexCount;
+            uint32_t commandCount;
+            uint32_t padding = 0;
+        };
+
+        struct Command {
+            ImVec4 clipRect;
+            uint32_t elementCount;
+            uint32_t indexOffset;
+            uint32_t vertexOffset;
+            uint32_t textured; // uses the font atlas, other textures can't be shared between processes
+        };
+
+        constexpr size_t align(size_t size) noexcept {
+            return (size + 7) & ~size_t(7);
+        }
+
+        // Bounds-checked reads: the plugin host isn't trusted to write valid frames
+        struct Reader {
+            const char * current;
+            const char * end;
+
+            template<typename T>
+            const T * read(size_t count = 1) noexcept {
+                const auto size = align(sizeof(T) * count);
+                if (size_t(end - current) < size)
+                    return nullptr;
+                const auto ret = reinterpret_cast<const T *>(current);
+                current += size;
+                return ret;
+            }
+        };
+    }
+
+    void initChannel(Channel & channel) noexcept {
+        channel.magic = magic;
+        channel.version = version;
+        channel.vertexSize = sizeof(ImDrawVert);
+        channel.indexSize = sizeof(ImDrawIdx);
+        channel.latestFrame.store(1);
+    }
+
+    void writeInput(Channel & channel, const Input & input) noexcept {
+        const auto sequence = channel.inputSequence.load(std::memory_order_relaxed);
+        channel.inputSequence.store(sequence + 1, std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_release);
+        std::memcpy(&channel.input, &input, sizeof(input));
+        channel.inputSequence.store(sequence + 2, std::memory_order_release);
+    }
+
+    Input captureInput(ImVec2 origin, ImVec2 size, bool hovered, bool active, bool focused) noexcept {
+        const auto & io = ImGui::GetIO();
+
+        Input input;
+        input.displayWidth = size.x;
+        input.displayHeight = size.y;
+        input.deltaTime = io.DeltaTime;
+        input.enabled = true;
+
+        if (hovered || active) {
+            input.mouseX = io.MousePos.x - origin.x;
+            input.mouseY = io.MousePos.y - origin.y;
+            for (int i = 0; i < 5; ++i)
+                input.mouseDown[i] = io.MouseDown[i];
+        }
+        if (hovered) {
+            input.mouseWheel = io.MouseWheel;
+            input.mouseWheelH = io.MouseWheelH;
+        }
+
+        if (focused) {
+            for (int key = ImGuiKey_NamedKey_BEGIN; key < ImGuiKey_NamedKey_END; ++key)
+                if (ImGui::IsKeyDown((ImGuiKey)key)) {
+                    const auto bit = key - ImGuiKey_NamedKey_BEGIN;
+                    input.keysDown[bit / 64] |= uint64_t(1) << (bit % 64);
+                }
+            for (const auto c : io.InputQueueCharacters)
+                if (input.characterCount < std::size(input.characters))
+                    input.characters[input.characterCount++] = c;
+        }
+
+        return input;
+    }
+
+    bool readInput(Channel & channel, Input & input, uint32_t & lastSequence) noexcept {
+        while (true) {
+            const auto before = channel.inputSequence.load(std::memory_order_acquire);
+            if (before == lastSequence)
+                return false;
+            if (before & 1) {
+                std::this_thread::yield();
+                continue;
+            }
+
+            std::memcpy(&input, &channel.input, sizeof(input));
+            std::atomic_thread_fence(std::memory_order_acquire);
+            if (channel.inputSequence.load(std::memory_order_relaxed) == before) {
+                lastSequence = before;
+                return true;
+            }
+        }
+    }
+
+    const FrameHeader * acquireFrame(Channel & channel, uint32_t & front) noexcept {
+        if (channel.latestFrame.load(std::memory_order_relaxed) & newFrameFlag) {
+            const auto latest = channel.latestFrame.exchange(front, std::memory_order_acq_rel) & indexMask;
+            if (latest >= frameCount)
+                return nullptr;
+            front = latest;
+        }
+        return reinterpret_cast<const FrameHeader *>(channel.getFrame(front));
+    }
+
+    bool publishFrame(Channel & channel, uint32_t & back, const ImDrawData & drawData, bool enabled) noexcept {
+        const auto start = std::chrono::steady_clock::now();
+
+        const auto frame = channel.getFrame(back);
+        const auto end = frame + frameCapacity;
+        auto current = frame + align(sizeof(FrameHeader));
+
+        const auto write = [&](const void * data, size_t size) noexcept {
+            const auto aligned = align(size);
+            if (size_t(end - current) < aligned)
+                return false;
+            std::memcpy(current, data, size);
+            current += aligned;
+            return true;
+        };
+
+        static uint64_t frameNumber = 0;
+        FrameHeader header;
+        header.number = ++frameNumber;
+        header.enabled = enabled;
+        for (int i = 0; i < drawData.CmdListsCount; ++i) {
+            const auto & list = *drawData.CmdLists[i];
+
+            const ListHeader listHeader{
+                .vertexCount = (uint32_t)list.VtxBuffer.Size,
+                .indexCount = (uint32_t)list.IdxBuffer.Size,
+                .commandCount = (uint32_t)list.CmdBuffer.Size
+            };
+            if (!write(&listHeader, sizeof(listHeader)))
+                return false;
+
+            for (const auto & cmd : list.CmdBuffer) {
+                const Command command{
+                    .clipRect = {
+                        cmd.ClipRect.x - drawData.DisplayPos.x, cmd.ClipRect.y - drawData.DisplayPos.y,
+                        cmd.ClipRect.z - drawData.DisplayPos.x, cmd.ClipRect.w - drawData.DisplayPos.y
+                    },
+                    .elementCount = cmd.UserCallback ? 0 : cmd.ElemCount,
+                    .indexOffset = cmd.IdxOffset,
+                    .vertexOffset = cmd.VtxOffset,
+                    .textured = cmd.GetTexID() == fontTexture
+                };
+                if (!write(&command, sizeof(command)))
+                    return false;
+            }
+
+            // Vertex and index buffers are copied as-is, the overlay applies its offset while compositing
+            if (!write(list.VtxBuffer.Data, list.VtxBuffer.size_in_bytes()) || !write(list.IdxBuffer.Data, list.IdxBuffer.size_in_bytes()))
+                return false;
+            ++header.listCount;
+        }
+
+        header.size = uint32_t(current - frame - align(sizeof(FrameHeader)));
+        header.encodeNanoseconds = std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - start).count();
+        std::memcpy(frame, &header, sizeof(header));
+
+        back = channel.latestFrame.exchange(back | newFrameFlag, std::memory_order_acq_rel) & indexMask;
+        return true;
+    }
+
+    namespace {
+        // Copies one command's triangles into `drawList`, rebasing its indices onto the vertices it uses
+        // Indices are read once each and clamped to those vertices, as the plugin host may change them after they were validated
+        void appendCommand(ImDrawList & drawList, const ImDrawVert * vertices, const ImDrawIdx * indices, uint32_t elementCount,
+                           ImDrawIdx minIndex, uint32_t vertexCount, ImVec2 offset) noexcept {
+            drawList.PrimReserve((int)elementCount, (int)vertexCount);
+            const auto base = drawList._VtxCurrentIdx;
+            for (uint32_t v = 0; v < vertexCount; ++v) {
+                auto vertex = vertices[v];
+                vertex.pos.x += offset.x;
+                vertex.pos.y += offset.y;
+                *drawList._VtxWritePtr++ = vertex;
+            }
+            for (uint32_t idx = 0; idx < elementCount; ++idx) {
+                uint32_t index = uint32_t(indices[idx]) - minIndex;
+                if (index >= vertexCount) // also catches indices below `minIndex`, which wrap around
+                    index = 0;
+                *drawList._IdxWritePtr++ = (ImDrawIdx)(base + index);
+            }
+            drawList._VtxCurrentIdx += vertexCount;
+        }
+    }
+
+    // The plugin host can still write the frame while it's being read, so each header is copied before being validated,
+    // and the copy is the only one used afterwards
+    bool appendFrame(const FrameHeader & sharedFrame, ImDrawList & drawList, ImVec2 offset, ImTextureID overlayFontTexture) noexcept {
+        FrameHeader frame;
+        std::memcpy(&frame, &sharedFrame, sizeof(frame));
+
+        const auto begin = reinterpret_cast<const char *>(&sharedFrame) + align(sizeof(FrameHeader));
+        if (frame.size > frameCapacity - align(sizeof(FrameHeader)))
+            return false;
+        Reader reader{ begin, begin + frame.size };
+
+        for (uint32_t i = 0; i < frame.listCount; ++i) {
+            const auto sharedList = reader.read<ListHeader>();
+            if (!sharedList)
+                return false;
+            ListHeader list;
+            std::memcpy(&list, sharedList, sizeof(list));
+
+            const auto commands = reader.read<Command>(list.commandCount);
+            const auto vertices = reader.read<ImDrawVert>(list.vertexCount);
+            const auto indices = reader.read<ImDrawIdx>(list.indexCount);
+            if (!commands || !vertices || !indices)
+                return false;
+
+            for (uint32_t c = 0; c < list.commandCount; ++c) {
+                Command command;
+                std::memcpy(&command, &commands[c], sizeof(command));
+                if (command.elementCount == 0 || !command.textured)
+                    continue;
+                if (command.indexOffset > list.indexCount || command.elementCount > list.indexCount - command.indexOffset)
+                    return false;
+                if (command.vertexOffset > list.vertexCount)
+                    return false;
+
+                const auto commandIndices = indices + command.indexOffset;
+                ImDrawIdx minIndex = std::numeric_limits<ImDrawIdx>::max();
+                ImDrawIdx maxIndex = 0;
+                for (uint32_t idx = 0; idx < command.elementCount; ++idx) {
+                    const ImDrawIdx index = commandIndices[idx];
+                    minIndex = std::min(minIndex, index);
+                    maxIndex = std::max(maxIndex, index);
+                }
+                const uint64_t first = uint64_t(command.vertexOffset) + minIndex;
+                const uint32_t vertexCount = uint32_t(maxIndex) - minIndex + 1;
+                if (first + vertexCount > list.vertexCount)
+                    return false;
+
+                const auto & clip = command.clipRect;
+                drawList.PushClipRect({ clip.x + offset.x, clip.y + offset.y }, { clip.z + offset.x, clip.w + offset.y }, true);
+                drawList.PushTextureID(overlayFontTexture);
+                appendCommand(drawList, vertices + first, commandIndices, command.elementCount, minIndex, vertexCount, offset);
+                drawList.PopTextureID();
+                drawList.PopClipRect();
+            }
+        }
+        return true;
+    }
+
+    void appendDrawList(const ImDrawList & source, ImDrawList & drawList) noexcept {
+        for (const auto & cmd : source.CmdBuffer) {
+            if (cmd.UserCallback) {
+                drawList.AddCallback(cmd.UserCallback, cmd.UserCallbackData);
+                continue;
+            }
+            if (cmd.ElemCount == 0)
+                continue;
+
+            const auto commandIndices = source.IdxBuffer.Data + cmd.IdxOffset;
+            const auto [minIndex, maxIndex] = std::minmax_element(commandIndices, commandIndices + cmd.ElemCount);
+            const auto vertices = source.VtxBuffer.Data + cmd.VtxOffset + *minIndex;
+
+            drawList.PushClipRect({ cmd.ClipRect.x, cmd.ClipRect.y }, { cmd.ClipRect.z, cmd.ClipRect.w }, true);
+            drawList.PushTextureID(cmd.GetTexID());
+            appendCommand(drawList, vertices, commandIndices, cmd.ElemCount, *minIndex, *maxIndex - *minIndex + 1, { 0.f, 0.f });
+            drawList.PopTextureID();
+            drawList.PopClipRect();
+        }
+    }
+
+    void applyInput(const Input & input, const Input & previous) noexcept {
+        auto & io = ImGui::GetIO();
+        io.DisplaySize = { std::max(input.displayWidth, 1.f), std::max(input.displayHeight, 1.f) };
+        io.DeltaTime = std::max(input.deltaTime, .0001f);
+
+        io.AddMousePosEvent(input.mouseX, input.mouseY);
+        for (int i = 0; i < 5; ++i)
+            if (input.mouseDown[i] != previous.mouseDown[i])
+                io.AddMouseButtonEvent(i, input.mouseDown[i]);
+        if (input.mouseWheel != 0.f || input.mouseWheelH != 0.f)
+            io.AddMouseWheelEvent(input.mouseWheelH, input.mouseWheel);
+
+        for (size_t word = 0; word < std::size(input.keysDown); ++word) {
+            const auto changed = input.keysDown[word] ^ previous.keysDown[word];
+            if (changed == 0)
+                continue;
+            for (int bit = 0; bit < 64; ++bit)
+                if (changed & (uint64_t(1) << bit))
+                    io.AddKeyEvent((ImGuiKey)(ImGuiKey_NamedKey_BEGIN + word * 64 + bit), input.keysDown[word] & (uint64_t(1) << bit));
+        }
+
+        for (uint32_t i = 0; i < std::min<uint32_t>(input.characterCount, std::size(input.characters)); ++i)
+            io.AddInputCharacter(input.characters[i]);
+    }
+
+    uint64_t getFontChecksum(const unsigned char * alpha8, int width, int height) noexcept {
+        uint64_t hash = 14695981039346656037ull;
+        for (size_t i = 0; i < size_t(width) * size_t(height); ++i) {
+            hash ^= alpha8[i];
+            hash *= 1099511628211ull;
+        }
+        return hash;
+    }
+}
@@ -0,0 +1,105 @@
+#pragma once
+
+// stl
+#include <atomic>
+#include <cfloat>
+#include <cstddef>
+#include <cstdint>
+
+#include "imgui.h"
+
+// Shared-memory protocol between the overlay and `koverlay-plugin-host`, which runs an ImGui plugin in its own process
+// The overlay publishes its input under a seqlock, and the plugin host answers with its draw data through a triple buffer,
+// so neither side ever waits for the other
+namespace drawDataTransport {
+    static constexpr uint32_t magic = 0x44564f4b; // "KOVD"
+    static constexpr uint32_t version = 1;
+    static constexpr size_t frameCapacity = 4 * 1024 * 1024;
+    static constexpr uint32_t frameCount = 3;
+
+    // Set as the plugin host's font texture, and replaced by the overlay's own (both atlases must be identical)
+    static const ImTextureID fontTexture = (ImTextureID)(intptr_t)1;
+
+    struct Input {
+        float displayWidth = 0.f;
+        float displayHeight = 0.f;
+        float mouseX = -FLT_MAX;
+        float mouseY = -FLT_MAX;
+        bool mouseDown[5] = {};
+        float mouseWheel = 0.f;
+        float mouseWheelH = 0.f;
+        uint64_t keysDown[(ImGuiKey_NamedKey_COUNT + 63) / 64] = {};
+        ImWchar characters[32] = {};
+        uint32_t characterCount = 0;
+        float deltaTime = 0.f;
+        float scale = 1.f;
+        bool enabled = false;
+    };
+
+    // Followed by `size` bytes of draw lists
+    struct FrameHeader {
+        uint64_t number = 0; // 0 until the plugin host publishes its first frame
+        uint32_t size = 0;
+        uint32_t listCount = 0;
+        uint64_t encodeNanoseconds = 0;
+        uint8_t enabled = 0; // not a bool, as the overlay reads it from the plugin host, which may write any value
+    };
+
+    struct Channel {
+        // Written by the overlay before starting the plugin host
+        uint32_t magic;
+        uint32_t version;
+        uint32_t vertexSize;
+        uint32_t indexSize;
+        uint64_t overlayProcess; // the plugin host exits if this process dies
+
+        // Written by the plugin host once it's loaded the plugin
+        std::atomic<uint32_t> ready;
+        uint32_t fontWidth;
+        uint32_t fontHeight;
+        uint64_t fontChecksum;
+
+        std::atomic<uint32_t> stop;
+
+        std::atomic<uint32_t> inputSequence; // odd while `input` is being written
+        Input input;
+
+        // Index of the last published frame, | `newFrameFlag` until the overlay picks it up
+        std::atomic<uint32_t> latestFrame;
+
+        static constexpr size_t getSize() noexcept { return sizeof(Channel) + frameCount * frameCapacity; }
+        char * getFrame(uint32_t index) noexcept { return reinterpret_cast<char *>(this + 1) + index * frameCapacity; }
+    };
+
+    static_assert(std::atomic<uint32_t>::is_always_lock_free, "Atomics must be lock-free to be shared between processes");
+
+    // Overlay side
+    static constexpr uint32_t initialFront = 2;
+    void initChannel(Channel & channel) noexcept;
+    void writeInput(Channel & channel, const Input & input) noexcept;
+    // Builds input from the current ImGui context, with mouse coordinates relative to `origin`
+    // The mouse is only forwarded when `hovered` or `active`, the wheel when `hovered`, and the keyboard when `focused`
+    Input captureInput(ImVec2 origin, ImVec2 size, bool hovered, bool active, bool focused) noexcept;
+    // Returns the last published frame. `front` is owned by the overlay, and swapped with the new frame if there is one
+    // Returns nullptr if the plugin host published an invalid frame index
+    // The frame stays in shared memory, so its header should be copied before being read
+    const FrameHeader * acquireFrame(Channel & channel, uint32_t & front) noexcept;
+    // Copies `frame` into `drawList`, offset by `offset` and clipped by its current clip rect
+    // Returns false if the frame is malformed
+    bool appendFrame(const FrameHeader & frame, ImDrawList & drawList, ImVec2 offset, ImTextureID overlayFontTexture) noexcept;
+
+    // Plugin host side
+    static constexpr uint32_t initialBack = 0;
+    // Returns true if the overlay has written new input since `lastSequence`
+    bool readInput(Channel & channel, Input & input, uint32_t & lastSequence) noexcept;
+    // Encodes `drawData` into `back`, which is owned by the plugin host, then publishes it
+    bool publishFrame(Channel & channel, uint32_t & back, const ImDrawData & drawData, bool enabled) noexcept;
+    // Feeds the current ImGui context the difference between `input` and `previous`
+    void applyInput(const Input & input, const Input & previous) noexcept;
+
+    // In-process side, for ImGui contexts owned by the overlay itself
+    // Copies `source` into `drawList` as-is, keeping its textures and callbacks
+    void appendDrawList(const ImDrawList & source, ImDrawList & drawList) noexcept;
+
+    uint64_t getFontChecksum(const unsigned char * alpha8, int width, int height) noexcept;
+}
@@ -0,0 +1,15 @@
+#pragma once
+
+// stl
+#include <string>
+#include <string_view>
+
+namespace jsonStreamHelper {
+    // Parses `json` straight into `obj`. Unknown keys are skipped, missing keys leave members untouched
+    // Strings are copied, so they must be read into types that own their characters (e.g. std::string, not std::string_view)
+    // Only reads: the overlay's state snapshots are written by binarySnapshotHelper (see SessionSystem), not as JSON
+    template<typename T>
+    bool read(std::string_view json, T & obj) noexcept;
+}
+
+#include "jsonStreamHelper.inl"
@@ -0,0 +1,378 @@
+#include "jsonStreamHelper.hpp"
+
+// stl
+#include <charconv>
+#include <cstring>
+#include <type_traits>
+
+#if !defined(KOVERLAY_JSON_NO_SIMD) && (defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2))
+# define KOVERLAY_JSON_SSE2
+# include <emmintrin.h>
+#endif
+
+// putils
+#include "reflection.hpp"
+
+// project
+#include "serializationTraits.hpp"
+
+namespace jsonStreamHelper {
+    namespace impl {
+        using namespace serializationTraits;
+
+        struct Reader {
+            std::string_view json;
+            size_t pos = 0;
+            std::string scratch; // Only used for strings containing escape sequences
+
+            bool atEnd() const noexcept {
+                return pos >= json.size();
+            }
+
+            char peek() const noexcept {
+                return atEnd() ? '\0' : json[pos];
+            }
+
+            void skipWhitespace() noexcept {
+                while (!atEnd()) {
+                    const char c = json[pos];
+                    if (c != ' ' && c != '\n' && c != '\r' && c != '\t')
+                        return;
+                    ++pos;
+                }
+            }
+
+            bool consume(char expected) noexcept {
+                skipWhitespace();
+                if (peek() != expected)
+                    return false;
+                ++pos;
+                return true;
+            }
+
+            bool consumeLiteral(std::string_view literal) noexcept {
+                skipWhitespace();
+                if (json.substr(pos, literal.size()) != literal)
+                    return false;
+                pos += literal.size();
+                return true;
+            }
+
+            // Returns the offset of the next '"' or '\\' at or after `from`
+            size_t findStringSpecial(size_t from) const noexcept {
+#ifdef KOVERLAY_JSON_SSE2
+                const auto quote = _mm_set1_epi8('"');
+                const auto backslash = _mm_set1_epi8('\\');
+                while (from + 16 <= json.size()) {
+                    const auto chunk = _mm_loadu_si128((const __m128i *)(json.data() + from));
+                    const auto matches = _mm_or_si128(_mm_cmpeq_epi8(chunk, quote), _mm_cmpeq_epi8(chunk, backslash));
+                    const auto mask = (unsigned)_mm_movemask_epi8(matches);
+                    if (mask != 0) {
+                        unsigned offset = 0;
+                        while (!(mask & (1u << offset)))
+                            ++offset;
+                        return from + offset;
+                    }
+                    from += 16;
+                }
+#endif
+                while (from < json.size() && json[from] != '"' && json[from] != '\\')
+                    ++from;
+                return from;
+            }
+
+            // On success, `out` views either `json` or `scratch`
+            bool readString(std::string_view & out) noexcept {
+                if (!consume('"'))
+                    return false;
+
+                const auto start = pos;
+                auto end = findStringSpecial(pos);
+                if (end >= json.size())
+                    return false;
+                if (json[end] == '"') {
+                    out = json.substr(start, end - start);
+                    pos = end + 1;
+                    return true;
+                }
+
+                scratch.assign(json.data() + start, end - start);
+                pos = end;
+                while (!atEnd()) {
+                    const char c = json[pos++];
+                    if (c == '"') {
+                        out = scratch;
+                        return true;
+                    }
+                    if (c != '\\') {
+                        const auto next = findStringSpecial(pos);
+                        scratch += c;
+                        scratch.append(json.data() + pos, std::min(next, json.size()) - pos);
+                        pos = next;
+                        continue;
+                    }
+
+                    if (atEnd())
+                        return false;
+                    switch (json[pos++]) {
+                        case '"': scratch += '"'; break;
+                        case '\\': scratch += '\\'; break;
+                        case '/': scratch += '/'; break;
+                        case 'b': scratch += '\b'; break;
+                        case 'f': scratch += '\f'; break;
+                        case 'n': scratch += '\n'; break;
+                        case 'r': scratch += '\r'; break;
+                        case 't': scratch += '\t'; break;
+                        case 'u': {
+                            unsigned codePoint;
+                            if (!readHex4(codePoint))
+                                return false;
+                            // Characters outside the BMP are escaped as a high then a low surrogate
+                            if (codePoint >= 0xd800 && codePoint < 0xdc00 && json.substr(pos, 2) == "\\u") {
+                                const auto low = pos;
+                                pos += 2;
+                                unsigned lowSurrogate;
+                                if (readHex4(lowSurrogate) && lowSurrogate >= 0xdc00 && lowSurrogate < 0xe000)
+                                    codePoint = 0x10000 + ((codePoint - 0xd800) << 10) + (lowSurrogate - 0xdc00);
+                                else
+                                    pos = low;
+                            }
+                            // Unpaired surrogates can't be encoded as UTF-8
+                            if (codePoint >= 0xd800 && codePoint < 0xe000)
+                                codePoint = 0xfffd;
+                            appendUTF8(codePoint);
+                            break;
+                        }
+                        default:
+                            return false;
+                    }
+                }
+                return false;
+            }
+
+            bool readHex4(unsigned & value) noexcept {
+                const auto begin = json.data() + pos;
+                const auto result = std::from_chars(begin, json.data() + std::min(pos + 4, json.size()), value, 16);
+                if (result.ptr != begin + 4)
+                    return false;
+                pos += 4;
+                return true;
+            }
+
+            void appendUTF8(unsigned codePoint) noexcept {
+                if (codePoint < 0x80)
+                    scratch += (char)codePoint;
+                else if (codePoint < 0x800) {
+                    scratch += (char)(0xc0 | (codePoint >> 6));
+                    scratch += (char)(0x80 | (codePoint & 0x3f));
+                }
+                else if (codePoint < 0x10000) {
+                    scratch += (char)(0xe0 | (codePoint >> 12));
+                    scratch += (char)(0x80 | ((codePoint >> 6) & 0x3f));
+                    scratch += (char)(0x80 | (codePoint & 0x3f));
+                }
+                else {
+                    scratch += (char)(0xf0 | (codePoint >> 18));
+                    scratch += (char)(0x80 | ((codePoint >> 12) & 0x3f));
+                    scratch += (char)(0x80 | ((codePoint >> 6) & 0x3f));
+                    scratch += (char)(0x80 | (codePoint & 0x3f));
+                }
+            }
+
+            template<typename Number>
+            bool readNumber(Number & value) noexcept {
+                skipWhitespace();
+                const auto begin = json.data() + pos;
+                const auto end = json.data() + json.size();
+                auto result = std::from_chars(begin, end, value);
+                if constexpr (std::is_integral_v<Number>)
+                    if (result.ec == std::errc() && result.ptr != end && (*result.ptr == '.' || *result.ptr == 'e' || *result.ptr == 'E')) {
+                        double d;
+                        result = std::from_chars(begin, end, d);
+                        value = (Number)d;
+                    }
+                if (result.ec != std::errc())
+                    return false;
+                pos += result.ptr - begin;
+                return true;
+            }
+
+            bool skipValue() noexcept {
+                skipWhitespace();
+                switch (peek()) {
+                    case '"': {
+                        std::string_view ignored;
+                        return readString(ignored);
+                    }
+                    case '{':
+                        ++pos;
+                        if (consume('}'))
+                            return true;
+                        do {
+                            std::string_view ignored;
+                            if (!readString(ignored) || !consume(':') || !skipValue())
+                                return false;
+                        } while (consume(','));
+                        return consume('}');
+                    case '[':
+                        ++pos;
+                        if (consume(']'))
+                            return true;
+                        do {
+                            if (!skipValue())
+                                return false;
+                        } while (consume(','));
+                        return consume(']');
+                    case 't':
+                        return consumeLiteral("true");
+                    case 'f':
+                        return consumeLiteral("false");
+                    case 'n':
+                        return consumeLiteral("null");
+                    default: {
+                        double ignored;
+                        return readNumber(ignored);
+                    }
+                }
+            }
+
+            template<typename T>
+            bool readValue(T & value) noexcept {
+                if constexpr (std::is_same_v<T, bool>) {
+                    if (consumeLiteral("true"))
+                        value = true;
+                    else if (consumeLiteral("false"))
+                        value = false;
+                    else
+                        return false;
+                    return true;
+                }
+                else if constexpr (std::is_enum_v<T>) {
+                    std::underlying_type_t<T> underlying;
+                    if (!readNumber(underlying))
+                        return false;
+                    value = (T)underlying;
+                    return true;
+                }
+                else if constexpr (std::is_arithmetic_v<T>) {
+                    if constexpr (std::is_floating_point_v<T>)
+                        if (consumeLiteral("null")) { // written for NaN and infinities
+                            value = 0;
+                            return true;
+                        }
+                    return readNumber(value);
+                }
+                else if constexpr (StringView<T> || CString<T>) {
+                    // `str` points into the input or into `scratch`, which the next escaped string overwrites
+                    static_assert(!std::is_pointer_v<T> && !std::is_same_v<T, std::string_view>, "JSON strings can only be read into types that own a copy");
+                    std::string_view str;
+                    if (!readString(str))
+                        return false;
+                    if constexpr (std::is_assignable_v<T &, std::string_view>)
+                        value = str;
+                    else {
+                        if (str.data() != scratch.data())
+                            scratch.assign(str);
+                        value = scratch.c_str();
+                    }
+                    return true;
+                }
+                else if constexpr (isOptional<T>::value) {
+                    if (consumeLiteral("null")) {
+                        value.reset();
+                        return true;
+                    }
+                    if (!value)
+                        value.emplace();
+                    return readValue(*value);
+                }
+                else if constexpr (putils::reflection::has_attributes<T>()) {
+                    if (!consume('{'))
+                        return false;
+                    if (consume('}'))
+                        return true;
+                    do {
+                        std::string_view key;
+                        if (!readString(key) || !consume(':'))
+                            return false;
+
+                        bool found = false;
+                        bool ok = true;
+                        putils::reflection::for_each_attribute(value, [&](const auto & attr) noexcept {
+                            if (found || key != attr.name)
+                                return;
+                            found = true;
+                            ok = readValue(attr.member);
+                        });
+                        if (!found)
+                            ok = skipValue();
+                        if (!ok)
+                            return false;
+                    } while (consume(','));
+                    return consume('}');
+                }
+                else if constexpr (Map<T>) {
+                    if (!consume('{'))
+                        return false;
+                    value.clear();
+                    if (consume('}'))
+                        return true;
+                    do {
+                        std::string_view key;
+                        if (!readString(key) || !consume(':'))
+                            return false;
+                        typename T::key_type parsedKey;
+                        if constexpr (std::is_constructible_v<typename T::key_type, std::string_view>)
+                            parsedKey = typename T::key_type(key);
+                        else {
+                            Reader keyReader{ .json = key };
+                            if (!keyReader.readNumber(parsedKey))
+                                return false;
+                        }
+                        if (!readValue(value[parsedKey]))
+                            return false;
+                    } while (consume(','));
+                    return consume('}');
+                }
+                else if constexpr (Range<T>) {
+                    if (!consume('['))
+                        return false;
+                    if constexpr (Resizable<T>)
+                        value.clear();
+                    if (consume(']'))
+                        return true;
+
+                    auto it = std::begin(value);
+                    do {
+                        if constexpr (Resizable<T>) {
+                            if (!readValue(value.emplace_back()))
+                                return false;
+                        }
+                        else {
+                            if (it == std::end(value)) {
+                                if (!skipValue())
+                                    return false;
+                                continue;
+                            }
+                            if (!readValue(*it))
+                                return false;
+                            ++it;
+                        }
+                    } while (consume(','));
+                    return consume(']');
+                }
+                else
+                    static_assert(alwaysFalse<T>, "Type cannot be read from JSON");
+            }
+        };
+    }
+
+    template<typename T>
+    bool read(std::string_view json, T & obj) noexcept {
+        impl::Reader reader{ .json = json };
+        if (!reader.readValue(obj))
+            return false;
+        reader.skipWhitespace();
+        return reader.atEnd();
+    }
+}
@@ -0,0 +1,211 @@
+#include "scheduledMainLoop.hpp"
+#include "kengine.hpp"
+
+// stl
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+// kengine functions
+#include "functions/Execute.hpp"
+
+// kengine helpers
+#include "helpers/commandLineHelper.hpp"
+#include "helpers/mainLoop.hpp"
+
+// api
+#include "FrameEndComponent.hpp"
+#include "SystemAccessComponent.hpp"
+
+// project
+#include "JobSystem.hpp"
+#include "WorkStealingPool.hpp"
+
+namespace {
+    struct Options {
+        bool parallelSystems = true;
+    };
+}
+
+#define refltype Options
+putils_reflection_info{
+    putils_reflection_custom_class_name(Scheduler);
+    putils_reflection_attributes(
+        putils_reflection_attribute(parallelSystems,
+            putils_reflection_metadata("help", "Run systems that declared what they access in parallel")
+        )
+    );
+};
+#undef refltype
+
+namespace {
+    struct impl {
+        struct Node {
+            kengine::EntityID id;
+            bool mainThread = true;
+            // Systems that must wait for this one, as they were created after it and conflict with it
+            std::vector<size_t> dependents;
+            size_t dependencyCount = 0;
+        };
+
+        // Rebuilt whenever the set of systems changes
+        static inline std::vector<kengine::EntityID> graphIds;
+        static inline std::vector<Node> nodes;
+        static inline std::unique_ptr<std::atomic<size_t>[]> remainingDependencies;
+
+        static inline WorkStealingPool * pool = nullptr;
+        static inline float deltaTime = 0.f;
+
+        // Systems ready to run on the main thread, and number of systems run this frame
+        static inline std::mutex mainMutex;
+        static inline std::condition_variable mainWakeUp;
+        static inline std::vector<size_t> mainReady;
+        static inline size_t completed = 0;
+
+        static void run() noexcept {
+            const auto options = kengine::parseCommandLine<Options>();
+            if (!options.parallelSystems) {
+                kengine::mainLoop::run();
+                return;
+            }
+
+            pool = &getJobPool();
+
+            auto start = std::chrono::steady_clock::now();
+            auto end = start;
+            while (kengine::isRunning()) {
+                deltaTime = std::chrono::duration<float>(end - start).count();
+                start = std::chrono::steady_clock::now();
+                runFrame();
+
+                const auto frameTime = std::chrono::duration<float>(std::chrono::steady_clock::now() - start).count();
+                for (const auto &[e, frameEnd]: kengine::entities.with<koverlay::FrameEndComponent>())
+                    frameEnd.onFrameEnd(frameTime);
+                end = std::chrono::steady_clock::now();
+            }
+        }
+
+        static void runFrame() noexcept {
+            static std::vector<kengine::EntityID> ids;
+            ids.clear();
+            for (const auto &[e, execute]: kengine::entities.with<kengine::functions::Execute>())
+                ids.push_back(e.id);
+            if (ids != graphIds)
+                buildGraph(ids);
+
+            completed = 0;
+            mainReady.clear();
+            for (size_t i = 0; i < nodes.size(); ++i)
+                remainingDependencies[i] = nodes[i].dependencyCount;
+            for (size_t i = 0; i < nodes.size(); ++i)
+                if (nodes[i].dependencyCount == 0)
+                    schedule(i);
+
+            std::unique_lock lock(mainMutex);
+            while (completed < nodes.size()) {
+                if (!mainReady.empty()) {
+                    const auto node = mainReady.back();
+                    mainReady.pop_back();
+                    lock.unlock();
+                    execute(node);
+                    lock.lock();
+                    continue;
+                }
+
+                // Only runs other systems, never jobs, which may take much longer than a frame
+                lock.unlock();
+                const bool helped = pool->runOne();
+                lock.lock();
+                if (!helped)
+                    mainWakeUp.wait(lock, [] { return completed == nodes.size() || !mainReady.empty(); });
+            }
+        }
+
+        static void schedule(size_t node) noexcept {
+            if (!nodes[node].mainThread) {
+                pool->push([node] { execute(node); }, WorkStealingPool::Kind::System);
+                return;
+            }
+
+            {
+                const std::lock_guard lock(mainMutex);
+                mainReady.push_back(node);
+            }
+            mainWakeUp.notify_one();
+        }
+
+        static void execute(size_t node) noexcept {
+            // The system may have been removed by another one earlier this frame
+            auto e = kengine::entities[nodes[node].id];
+            if (const auto execute = e.tryGet<kengine::functions::Execute>())
+                (*execute)(deltaTime);
+
+            for (const auto dependent: nodes[node].dependents)
+                if (--remainingDependencies[dependent] == 0)
+                    schedule(dependent);
+
+            {
+                const std::lock_guard lock(mainMutex);
+                ++completed;
+            }
+            mainWakeUp.notify_one();
+        }
+
+        static void buildGraph(const std::vector<kengine::EntityID> &ids) noexcept {
+            graphIds = ids;
+            nodes.clear();
+            nodes.resize(ids.size());
+            remainingDependencies = std::make_unique<std::atomic<size_t>[]>(ids.size());
+
+            static std::vector<const koverlay::SystemAccessComponent *> systemAccesses;
+            systemAccesses.clear();
+            for (size_t i = 0; i < ids.size(); ++i) {
+                const auto access = kengine::entities[ids[i]].tryGet<koverlay::SystemAccessComponent>();
+                systemAccesses.push_back(access);
+
+                auto &node = nodes[i];
+                node.id = ids[i];
+                node.mainThread = !access || access->mainThread || accesses(*access, koverlay::resources::imgui);
+
+                // Systems keep their creation order whenever they conflict
+                for (size_t j = 0; j < i; ++j)
+                    if (conflict(systemAccesses[j], access)) {
+                        nodes[j].dependents.push_back(i);
+                        ++node.dependencyCount;
+                    }
+            }
+        }
+
+        static bool conflict(const koverlay::SystemAccessComponent *lhs, const koverlay::SystemAccessComponent *rhs) noexcept {
+            if (!lhs || !rhs)
+                return true;
+
+            const auto writesAnyOf = [](const koverlay::SystemAccessComponent &writer, const std::vector<std::string> &resources) noexcept {
+                return std::ranges::any_of(resources, [&](const std::string &resource) {
+                    return std::ranges::find(writer.writes, resource) != writer.writes.end();
+                });
+            };
+            const auto writesEntities = [](const koverlay::SystemAccessComponent &access) noexcept {
+                return std::ranges::find(access.writes, koverlay::resources::entities) != access.writes.end();
+            };
+
+            return writesEntities(*lhs) || writesEntities(*rhs) ||
+                writesAnyOf(*lhs, rhs->reads) || writesAnyOf(*lhs, rhs->writes) || writesAnyOf(*rhs, lhs->reads);
+        }
+
+        static bool accesses(const koverlay::SystemAccessComponent &access, const std::string &resource) noexcept {
+            return std::ranges::find(access.reads, resource) != access.reads.end() ||
+                std::ranges::find(access.writes, resource) != access.writes.end();
+        }
+    };
+}
+
+namespace scheduledMainLoop {
+    void run() noexcept {
+        impl::run();
+    }
+}
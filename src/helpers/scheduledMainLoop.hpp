@@ -0,0 +1,9 @@
+#pragma once
+
+// Replaces kengine::mainLoop::run: calls every functions::Execute each frame, running systems that declared non-conflicting
+// accesses (see SystemAccessComponent) in parallel, on the job system's threads, then each FrameEndComponent
+// Rendering isn't pipelined: kengine's OpenGLSystem builds, submits and swaps each frame from a single Execute, which
+// runs on the main thread like other undeclared systems. Submitting on a separate thread would require splitting that system
+namespace scheduledMainLoop {
+    void run() noexcept;
+}
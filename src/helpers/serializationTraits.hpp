@@ -0,0 +1,33 @@
+#pragma once
+
+// stl
+#include <iterator>
+#include <optional>
+#include <string_view>
+#include <type_traits>
+
+// Type categories shared by the reflection-based serializers
+namespace serializationTraits {
+    template<typename T>
+    struct isOptional : std::false_type {};
+    template<typename T>
+    struct isOptional<std::optional<T>> : std::true_type {};
+
+    template<typename T>
+    concept StringView = std::is_convertible_v<const T &, std::string_view>;
+
+    template<typename T>
+    concept CString = requires(const T & t) { { t.c_str() } -> std::convertible_to<const char *>; };
+
+    template<typename T>
+    concept Map = requires { typename T::key_type; typename T::mapped_type; };
+
+    template<typename T>
+    concept Range = requires(T & t) { std::begin(t); std::end(t); };
+
+    template<typename T>
+    concept Resizable = requires(T & t) { t.clear(); t.emplace_back(); };
+
+    template<typename T>
+    constexpr bool alwaysFalse = false;
+}
@@ -0,0 +1,21 @@
+#pragma once
+
+// stl
+#include <array>
+
+// api
+#include "StaticImGuiPlugin.hpp"
+
+// Plugins linked into the executable, listed by the KOVERLAY_STATIC_PLUGINS CMake option
+// The lists are generated at configure time, so iterating them calls each plugin directly, without loading or looking anything up
+namespace staticPlugins {
+    using LoadKenginePluginFunc = void (void * state);
+
+    template<typename T, typename ... Args>
+    constexpr std::array<T, sizeof...(Args)> makeList(Args ... args) noexcept {
+        return { args... };
+    }
+}
+
+// Declares each plugin's entry point, and defines `staticPlugins::kenginePlugins` and `staticPlugins::imguiPlugins`
+#include "staticPluginList.inl"
@@ -0,0 +1,170 @@
+#include "threadPlacement.hpp"
+
+// stl
+#include <algorithm>
+#include <charconv>
+
+#ifdef _WIN32
+# include <windows.h>
+#else
+# include <pthread.h>
+# include <sched.h>
+# include <sys/resource.h>
+#endif
+
+namespace threadPlacement {
+    namespace {
+        uint64_t processCores = 0;
+    }
+
+    void init() noexcept {
+#ifdef _WIN32
+        DWORD_PTR processMask, systemMask;
+        if (GetProcessAffinityMask(GetCurrentProcess(), &processMask, &systemMask))
+            processCores = (uint64_t)processMask;
+#else
+        cpu_set_t set;
+        if (sched_getaffinity(0, sizeof(set), &set) == 0)
+            for (int i = 0; i < 64; ++i)
+                if (CPU_ISSET(i, &set))
+                    processCores |= uint64_t(1) << i;
+#endif
+    }
+
+    bool setCores(uint64_t cores) noexcept {
+        if (cores == 0)
+            cores = processCores;
+        if (cores == 0)
+            return false;
+#ifdef _WIN32
+        return SetThreadAffinityMask(GetCurrentThread(), (DWORD_PTR)cores) != 0;
+#else
+        cpu_set_t set;
+        CPU_ZERO(&set);
+        for (int i = 0; i < 64; ++i)
+            if (cores & (uint64_t(1) << i))
+                CPU_SET(i, &set);
+        // On Linux, pid 0 is the calling thread rather than the whole process
+        return sched_setaffinity(0, sizeof(set), &set) == 0;
+#endif
+    }
+
+    bool setPriority(Policy policy, int nice) noexcept {
+#ifdef _WIN32
+        const int priorities[] = { THREAD_PRIORITY_NORMAL, THREAD_PRIORITY_BELOW_NORMAL, THREAD_PRIORITY_IDLE };
+        return SetThreadPriority(GetCurrentThread(), priorities[(int)policy]) != 0;
+#else
+        bool ret = true;
+# ifdef __linux__
+        const int policies[] = { SCHED_OTHER, SCHED_BATCH, SCHED_IDLE };
+        const sched_param param{ .sched_priority = 0 };
+        ret = pthread_setschedparam(pthread_self(), policies[(int)policy], &param) == 0;
+# endif
+        // Also per-thread on Linux. Lowering the nice value again may require privileges
+        return setpriority(PRIO_PROCESS, 0, nice) == 0 && ret;
+#endif
+    }
+
+    Placement get() noexcept {
+        Placement ret;
+#ifdef _WIN32
+        ret.currentCore = (int)GetCurrentProcessorNumber();
+        // Reading a thread's affinity requires setting it
+        const auto previous = SetThreadAffinityMask(GetCurrentThread(), (DWORD_PTR)processCores);
+        if (previous != 0) {
+            SetThreadAffinityMask(GetCurrentThread(), previous);
+            ret.cores = (uint64_t)previous;
+        }
+        switch (GetThreadPriority(GetCurrentThread())) {
+            case THREAD_PRIORITY_BELOW_NORMAL:
+                ret.policy = Policy::Batch;
+                break;
+            case THREAD_PRIORITY_IDLE:
+                ret.policy = Policy::Idle;
+                break;
+            default:
+                break;
+        }
+#else
+# ifdef __linux__
+        ret.currentCore = sched_getcpu();
+        cpu_set_t set;
+        if (sched_getaffinity(0, sizeof(set), &set) == 0)
+            for (int i = 0; i < 64; ++i)
+                if (CPU_ISSET(i, &set))
+                    ret.cores |= uint64_t(1) << i;
+
+        int policy;
+        sched_param param;
+        if (pthread_getschedparam(pthread_self(), &policy, &param) == 0)
+            ret.policy = policy == SCHED_BATCH ? Policy::Batch : policy == SCHED_IDLE ? Policy::Idle : Policy::Normal;
+# endif
+        ret.nice = getpriority(PRIO_PROCESS, 0);
+#endif
+        return ret;
+    }
+
+    std::optional<uint64_t> parseCores(std::string_view list) noexcept {
+        uint64_t ret = 0;
+        while (!list.empty()) {
+            const auto comma = std::min(list.find(','), list.size());
+            const auto range = list.substr(0, comma);
+            list.remove_prefix(std::min(comma + 1, list.size()));
+
+            unsigned first, last;
+            const auto end = range.data() + range.size();
+            auto result = std::from_chars(range.data(), end, first);
+            if (result.ec != std::errc())
+                return std::nullopt;
+            last = first;
+            if (result.ptr != end) {
+                if (*result.ptr != '-')
+                    return std::nullopt;
+                result = std::from_chars(result.ptr + 1, end, last);
+                if (result.ec != std::errc() || result.ptr != end)
+                    return std::nullopt;
+            }
+            if (first > last || last >= 64)
+                return std::nullopt;
+
+            for (auto i = first; i <= last; ++i)
+                ret |= uint64_t(1) << i;
+        }
+        return ret;
+    }
+
+    std::string formatCores(uint64_t cores) noexcept {
+        if (cores == 0)
+            return "all";
+
+        std::string ret;
+        for (int i = 0; i < 64;) {
+            if (!(cores & (uint64_t(1) << i))) {
+                ++i;
+                continue;
+            }
+
+            int last = i;
+            while (last + 1 < 64 && (cores & (uint64_t(1) << (last + 1))))
+                ++last;
+            if (!ret.empty())
+                ret += ',';
+            ret += std::to_string(i);
+            if (last > i)
+                ret += '-' + std::to_string(last);
+            i = last + 1;
+        }
+        return ret;
+    }
+
+    const char * getPolicyName(Policy policy) noexcept {
+        switch (policy) {
+            case Policy::Batch:
+                return "batch";
+            case Policy::Idle:
+                return "idle";
+            default:
+                return "normal";
+        }
+    }
+}
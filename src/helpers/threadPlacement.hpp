@@ -0,0 +1,36 @@
+#pragma once
+
+// stl
+#include <cstdint>
+#include <optional>
+#include <string>
+#include <string_view>
+
+// Cores and scheduling priority of the calling thread
+// Core sets are masks of the first 64 cores, where 0 means all the cores the process was started with
+namespace threadPlacement {
+    enum class Policy {
+        Normal,
+        Batch, // SCHED_BATCH on Linux, below normal priority on Windows
+        Idle, // SCHED_IDLE on Linux, idle priority on Windows
+    };
+
+    struct Placement {
+        int currentCore = -1;
+        uint64_t cores = 0;
+        Policy policy = Policy::Normal;
+        int nice = 0; // always 0 on Windows
+    };
+
+    // Must be called before any thread changes its cores, to remember the process' original ones
+    void init() noexcept;
+
+    bool setCores(uint64_t cores) noexcept;
+    bool setPriority(Policy policy, int nice) noexcept;
+    Placement get() noexcept;
+
+    // Parses lists such as "0-3,6"
+    std::optional<uint64_t> parseCores(std::string_view list) noexcept;
+    std::string formatCores(uint64_t cores) noexcept;
+    const char * getPolicyName(Policy policy) noexcept;
+}
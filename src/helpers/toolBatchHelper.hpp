@@ -0,0 +1,56 @@
+#pragma once
+
+// stl
+#include <optional>
+#include <span>
+#include <string>
+
+// kengine
+#include "kengine.hpp"
+
+// kengine data
+#include "data/ImGuiToolComponent.hpp"
+#include "data/NameComponent.hpp"
+
+// api
+#include "ToolMetadataComponent.hpp"
+
+// project
+#include "ToolIndexSystem.hpp"
+#include "toolManifestHelper.hpp"
+
+namespace toolBatchHelper {
+    struct Tool {
+        std::string name;
+        bool enabled = false;
+        std::optional<koverlay::ToolMetadataComponent> metadata;
+    };
+
+    inline Tool fromManifest(ToolManifest && manifest) noexcept {
+        return {
+            .name = std::move(manifest.name),
+            .enabled = manifest.enabled,
+            .metadata = koverlay::ToolMetadataComponent{ std::move(manifest.category), manifest.cost }
+        };
+    }
+
+    // Creates one entity per tool, attaching its NameComponent, ImGuiToolComponent and whatever `attach(e, i)` adds for `tools[i]`
+    // Entities are still created one at a time, as kengine can neither create them in bulk nor reserve their storage. What the batch
+    // saves is on the overlay's side: the tool index and enabled set are reserved up front, and the index is only sorted once
+    template<typename Func>
+    void createTools(std::span<const Tool> tools, Func && attach) noexcept {
+        if (tools.empty())
+            return;
+
+        beginToolBatch(tools.size());
+        for (size_t i = 0; i < tools.size(); ++i)
+            kengine::entities += [&](kengine::Entity & e) {
+                e += kengine::NameComponent{ tools[i].name };
+                e += kengine::ImGuiToolComponent{ tools[i].enabled };
+                if (tools[i].metadata)
+                    e += *tools[i].metadata;
+                attach(e, i);
+            };
+        endToolBatch();
+    }
+}
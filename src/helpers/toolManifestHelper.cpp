@@ -0,0 +1,125 @@
+#include "toolManifestHelper.hpp"
+
+// stl
+#include <charconv>
+#include <fstream>
+#include <iterator>
+#include <string_view>
+
+// putils
+#include "reflection.hpp"
+
+// project
+#include "jsonStreamHelper.hpp"
+
+#define refltype ToolManifest
+putils_reflection_info{
+    putils_reflection_attributes(
+        putils_reflection_attribute(name),
+        putils_reflection_attribute(enabled),
+        putils_reflection_attribute(category),
+        putils_reflection_attribute(cost),
+        putils_reflection_attribute(sandbox)
+    );
+};
+#undef refltype
+
+namespace toolManifestHelper {
+    std::optional<ToolManifest> readSidecar(const std::string & path) noexcept {
+        const auto dot = path.find_last_of('.');
+        const auto sidecar = path.substr(0, dot) + ".tool.json";
+
+        std::ifstream f(sidecar, std::ios::binary);
+        if (!f)
+            return std::nullopt;
+        const std::string content{ std::istreambuf_iterator<char>(f), std::istreambuf_iterator<char>() };
+
+        ToolManifest manifest;
+        if (!jsonStreamHelper::read(content, manifest) || manifest.name.empty())
+            return std::nullopt;
+        return manifest;
+    }
+
+    std::optional<ToolManifest> readLuaHeader(const std::string & path) noexcept {
+        std::ifstream f(path);
+        std::string line;
+        ToolManifest manifest;
+        while (std::getline(f, line)) {
+            auto view = std::string_view(line);
+            if (!view.empty() && view.back() == '\r')
+                view.remove_suffix(1);
+            if (!view.starts_with("--"))
+                break;
+
+            const auto at = view.find_first_not_of("- \t");
+            if (at == std::string_view::npos || view[at] != '@')
+                continue;
+            view.remove_prefix(at + 1);
+
+            const auto space = view.find_first_of(" \t");
+            if (space == std::string_view::npos)
+                continue;
+            const auto start = view.find_first_not_of(" \t", space);
+            if (start == std::string_view::npos)
+                continue;
+            const auto key = view.substr(0, space);
+            const auto value = view.substr(start, view.find_last_not_of(" \t") - start + 1);
+
+            if (key == "name")
+                manifest.name = value;
+            else if (key == "enabled")
+                manifest.enabled = value == "true";
+            else if (key == "category")
+                manifest.category = value;
+            else if (key == "cost")
+                std::from_chars(value.data(), value.data() + value.size(), manifest.cost);
+        }
+
+        if (manifest.name.empty())
+            return std::nullopt;
+        return manifest;
+    }
+
+    std::optional<ToolManifest> readLuaAssignments(const std::string & path) noexcept {
+        std::ifstream f(path);
+        std::string line;
+        ToolManifest manifest;
+        while (std::getline(f, line)) {
+            const auto view = std::string_view(line);
+            const auto readValue = [&](std::string_view variable) noexcept -> std::optional<std::string_view> {
+                if (!view.starts_with(variable))
+                    return std::nullopt;
+                auto value = view.substr(variable.size());
+                const auto equal = value.find_first_not_of(" \t");
+                if (equal == std::string_view::npos || value[equal] != '=')
+                    return std::nullopt;
+                value.remove_prefix(equal + 1);
+                const auto start = value.find_first_not_of(" \t");
+                const auto end = value.find_last_not_of(" \t\r;");
+                if (start == std::string_view::npos)
+                    return std::nullopt;
+                return value.substr(start, end - start + 1);
+            };
+
+            // Anything but a single literal (concatenation, escapes, a call...) is left for the script to evaluate
+            if (const auto name = readValue("TOOL_NAME")) {
+                if (name->size() < 2 || (name->front() != '"' && name->front() != '\''))
+                    return std::nullopt;
+                const char delimiters[] = { name->front(), '\\' };
+                const auto closing = name->find_first_of(std::string_view{ delimiters, 2 }, 1);
+                if (closing != name->size() - 1 || name->back() != name->front())
+                    return std::nullopt;
+                manifest.name = name->substr(1, name->size() - 2);
+            }
+            else if (const auto enabled = readValue("TOOL_ENABLED")) {
+                if (*enabled != "true" && *enabled != "false")
+                    return std::nullopt;
+                manifest.enabled = *enabled == "true";
+            }
+        }
+
+        if (manifest.name.empty())
+            return std::nullopt;
+        return manifest;
+    }
+}
@@ -0,0 +1,29 @@
+#pragma once
+
+// stl
+#include <optional>
+#include <string>
+
+// Tool metadata that the overlay can read without running or loading the tool's code
+// Either a `<name>.tool.json` file next to the script or plugin, e.g.
+//     { "name": "Example", "enabled": false, "category": "Debug", "cost": 0.5, "sandbox": false }
+// or, for Lua scripts, a comment header at the top of the file:
+//     -- @name Example
+//     -- @enabled false
+//     -- @category Debug
+//     -- @cost 0.5
+struct ToolManifest {
+    std::string name;
+    bool enabled = false;
+    std::string category;
+    float cost = 0.f;
+    bool sandbox = false; // ImGui plugins only: run in a separate process
+};
+
+namespace toolManifestHelper {
+    std::optional<ToolManifest> readSidecar(const std::string & path) noexcept;
+    std::optional<ToolManifest> readLuaHeader(const std::string & path) noexcept;
+    // Top-level `TOOL_NAME = "..."` (and optional `TOOL_ENABLED = true`) assignments, for scripts without a manifest
+    // Returns nullopt unless they're plain literals (a single string without escapes, `true` or `false`), so the script gets run instead
+    std::optional<ToolManifest> readLuaAssignments(const std::string & path) noexcept;
+}
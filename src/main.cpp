@@ -1,4 +1,5 @@
 #include <optional>
+#include <vector>
 
 #include <GLFW/glfw3.h>
 
@@ -11,12 +12,10 @@
 
 // putils
 #include "go_to_bin_dir.hpp"
-#include "PluginManager.hpp"
 #include "on_scope_exit.hpp"
 
 // kengine systems
 #include "systems/glfw/GLFWSystem.hpp"
-#include "systems/imgui_tool/ImGuiToolSystem.hpp"
 #include "systems/imgui_prompt/ImGuiPromptSystem.hpp"
 #include "systems/imgui_adjustable/ImGuiAdjustableSystem.hpp"
 #include "systems/log_file/LogFileSystem.hpp"
@@ -40,13 +39,29 @@
 
 // kengine helpers
 #include "helpers/mainLoop.hpp"
-#include "helpers/sortHelper.hpp"
 
 // systems
 #include "ImGuiPluginSystem.hpp"
 #include "ImGuiLuaSystem.hpp"
+#include "SessionSystem.hpp"
+#include "AdjustableStoreSystem.hpp"
+#include "ToolIndexSystem.hpp"
+#include "ToolMenuSystem.hpp"
+#include "ComponentEventsSystem.hpp"
+#include "FeedSystem.hpp"
+#include "JobSystem.hpp"
+#include "ThreadPlacementSystem.hpp"
+#include "FileTailSystem.hpp"
+#include "LuaBufferSystem.hpp"
+#include "LuaGCSystem.hpp"
+
+// api
+#include "ComponentEventsComponent.hpp"
+#include "ToolIndexComponent.hpp"
 
 // src
+#include "OverlayState.hpp"
+#include "helpers/scheduledMainLoop.hpp"
 #include "types/registerTypes.hpp"
 
 #include "command_line_arguments.hpp"
@@ -100,16 +115,20 @@ namespace {
             if (!options.showWindow)
                 ShowWindow(GetConsoleWindow(), SW_HIDE);
 #endif
-            if (options.scale)
+            if (options.scale) {
                 setScale(*options.scale);
+                ignoreStoredAdjustable("ImGui", "Scale");
+            }
 
             createAndHideWindow();
-            loadPlugins();
+            loadKenginePlugins();
 
             setupSystemTray();
             const auto _ = setupKeyboardHook();
 
-            kengine::mainLoop::run();
+            scheduledMainLoop::run();
+            saveSession();
+            saveAdjustables();
         }
 
         static void addSystems() noexcept {
@@ -130,11 +149,21 @@ namespace {
             // ImGui
             kengine::entities += kengine::ImGuiAdjustableSystem();
             kengine::entities += kengine::ImGuiPromptSystem();
-            kengine::entities += kengine::ImGuiToolSystem();
 
             // project
+            kengine::entities += ThreadPlacementSystem();
+            kengine::entities += JobSystem();
+            kengine::entities += ComponentEventsSystem();
+            kengine::entities += ToolIndexSystem();
+            kengine::entities += ToolMenuSystem();
             kengine::entities += ImGuiPluginSystem();
+            kengine::entities += FeedSystem();
+            kengine::entities += FileTailSystem();
             kengine::entities += ImGuiLuaSystem();
+            kengine::entities += LuaBufferSystem();
+            kengine::entities += LuaGCSystem();
+            kengine::entities += SessionSystem();
+            kengine::entities += AdjustableStoreSystem();
         }
 
         static void setScale(float scale) noexcept {
@@ -150,11 +179,6 @@ namespace {
             }
         }
 
-        static void loadPlugins() noexcept {
-            putils::PluginManager pm;
-            pm.rescanDirectory("plugins", "loadKenginePlugin", kengine::getState());
-        }
-
 #ifdef _WIN32
 # define MY_SYSTEM_TRAY_MESSAGE (WM_APP + 1) // arbitrary value between WP_APP and 0xBFFF
 #endif
@@ -189,8 +213,10 @@ namespace {
 #endif
 #else // _WIN32
             for (auto [e, name, tool] : kengine::entities.with<kengine::NameComponent, kengine::ImGuiToolComponent>())
-                if (name.name == "Controller")
+                if (name.name == "Controller" && !tool.enabled) {
                     tool.enabled = true;
+                    koverlay::componentEvents::notifyModified<kengine::ImGuiToolComponent>(e);
+                }
 #endif // _WIN32
         }
 
@@ -206,12 +232,6 @@ namespace {
 #endif
         }
 
-        static inline bool g_enabled = true;
-
-        struct ToolSave {
-            bool enabled = false;
-        };
-
 #ifdef _WIN32
         static LRESULT wndProc(HWND hwnd, UINT umsg, WPARAM wParam, LPARAM lParam) {
             if (umsg == MY_SYSTEM_TRAY_MESSAGE) {
@@ -227,29 +247,22 @@ namespace {
                 }
             } else if (umsg == WM_COMMAND) { // In context menu
                 const auto id = LOWORD(wParam);
-                size_t i = 0;
-                bool found = false;
-                auto sorted = kengine::sortHelper::getNameSortedEntities<0, kengine::ImGuiToolComponent>();
-                for (auto &[e, name, tool]: sorted) {
-                    if (id != i) {
-                        ++i;
-                        continue;
+                const auto tools = koverlay::getSortedTools();
+                if (id < tools.size()) {
+                    auto e = kengine::entities[tools[id].id];
+                    if (g_overlayEnabled) {
+                        auto & tool = e.get<kengine::ImGuiToolComponent>();
+                        tool.enabled = !tool.enabled;
+                        koverlay::componentEvents::notifyModified<kengine::ImGuiToolComponent>(e);
                     }
-
-                    if (g_enabled)
-                        tool->enabled = !tool->enabled;
                     else {
-                        auto &save = e.attach<ToolSave>();
+                        auto & save = e.attach<ToolSave>();
                         save.enabled = !save.enabled;
                     }
-
-                    found = true;
-                    break;
                 }
-
-                if (!found) { // "Exit"
+                else { // "Exit"
                     kengine::stopRunning();
-                    if (!g_enabled)
+                    if (!g_overlayEnabled)
                         toggleAllTools();
                 }
             } else
@@ -267,13 +280,10 @@ namespace {
             glfwFocusWindow(g_window);
             hMenu = CreatePopupMenu();
 
-            size_t i = 0;
-            const auto sorted = kengine::sortHelper::getNameSortedEntities<0, kengine::ImGuiToolComponent>();
-            for (const auto &[e, name, tool]: sorted) {
-                AppendMenu(hMenu, MF_STRING, i, name->name);
-                ++i;
-            }
-            AppendMenu(hMenu, MF_STRING, i, "Exit");
+            const auto tools = koverlay::getSortedTools();
+            for (size_t i = 0; i < tools.size(); ++i)
+                AppendMenu(hMenu, MF_STRING, i, tools[i].name.c_str());
+            AppendMenu(hMenu, MF_STRING, tools.size(), "Exit");
 
             POINT curPoint;
             GetCursorPos(&curPoint);
@@ -313,24 +323,36 @@ namespace {
         static void toggleAllTools() noexcept {
             glfwFocusWindow(g_window);
 
-            for (auto[e, name, tool]: kengine::entities.with<kengine::NameComponent, kengine::ImGuiToolComponent>())
-                if (g_enabled) {
+            static std::vector<kengine::EntityID> toggled;
+            toggled.clear();
+            for (auto[e, name, tool]: kengine::entities.with<kengine::NameComponent, kengine::ImGuiToolComponent>()) {
+                const bool wasEnabled = tool.enabled;
+                if (g_overlayEnabled) {
                     e += ToolSave{tool.enabled};
                     tool.enabled = false;
                 } else
                     tool.enabled = e.attach<ToolSave>().enabled;
+                if (tool.enabled != wasEnabled)
+                    toggled.push_back(e.id);
+            }
 
             static bool first = true; // Don't know why, first time this is called it leaves one of the tools open
-            if (first && g_enabled) {
+            if (first && g_overlayEnabled) {
                 first = false;
                 for (auto[e, name, tool]: kengine::entities.with<kengine::NameComponent, kengine::ImGuiToolComponent>())
                     if (tool.enabled) {
                         e += ToolSave{tool.enabled};
                         tool.enabled = false;
+                        toggled.push_back(e.id);
                     }
             }
 
-            g_enabled = !g_enabled;
+            g_overlayEnabled = !g_overlayEnabled;
+
+            for (const auto id : toggled) {
+                auto e = kengine::entities[id];
+                koverlay::componentEvents::notifyModified<kengine::ImGuiToolComponent>(e);
+            }
         }
     };
 }